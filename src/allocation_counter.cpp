@@ -0,0 +1,30 @@
+#include "allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t allocationCount = 0;
+
+uint64_t threadAllocationCount()
+{
+    return allocationCount;
+}
+
+// The array and nothrow forms forward to these by default.
+void *operator new(std::size_t size)
+{
+    allocationCount++;
+    if (void *p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,10 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// Number of operator new calls made by the calling thread so far. Only linked into builds
+// configured with WITH_ALLOCATION_CHECKS, which replace the global operator new.
+uint64_t threadAllocationCount();
+
+#endif // ALLOCATION_COUNTER_H
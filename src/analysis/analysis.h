@@ -5,7 +5,9 @@
 #include "freqz/freqz.h"
 #include "pitch/pitch.h"
 #include "filter/filter.h"
+#include "window/window.h"
 #include "filterbanks/filterbanks.h"
+#include "spectrogram/spectrogram.h"
 #include "linpred/linpred.h"
 #include "formant/formant.h"
 #include "invglot/invglot.h"
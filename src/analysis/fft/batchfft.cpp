@@ -0,0 +1,97 @@
+#include "fft.h"
+
+using namespace Analysis;
+
+RealFFTBatch::RealFFTBatch(int n, int howMany)
+    : mSize(n),
+      mHowMany(howMany),
+      mIn(fftw_alloc_real(n * howMany)),
+      mOut(fftw_alloc_complex((n / 2 + 1) * howMany))
+{
+    QMutexLocker lock(&sFFTWPlanMutex);
+    importFFTWisdom();
+    mPlanForward = fftw_plan_many_dft_r2c(
+            1, &n, howMany,
+            mIn, nullptr, 1, n,
+            mOut, nullptr, 1, n / 2 + 1,
+            FFTW_EM_FLAG);
+}
+
+RealFFTBatch::~RealFFTBatch()
+{
+    QMutexLocker lock(&sFFTWPlanMutex);
+    fftw_destroy_plan(mPlanForward);
+    fftw_free(mIn);
+    fftw_free(mOut);
+}
+
+double *RealFFTBatch::input(int row)
+{
+    return mIn + row * mSize;
+}
+
+std::dcomplex *RealFFTBatch::output(int row)
+{
+    return &std::cast_dcomplex(mOut[row * (mSize / 2 + 1)]);
+}
+
+void RealFFTBatch::computeForward()
+{
+    fftw_execute(mPlanForward);
+}
+
+int RealFFTBatch::getInputLength() const
+{
+    return mSize;
+}
+
+int RealFFTBatch::getOutputLength() const
+{
+    return mSize / 2 + 1;
+}
+
+int RealFFTBatch::getBatchSize() const
+{
+    return mHowMany;
+}
+
+ReReFFTBatch::ReReFFTBatch(int n, int howMany, fftw_r2r_kind method)
+    : mSize(n),
+      mHowMany(howMany),
+      mData(fftw_alloc_real(n * howMany))
+{
+    QMutexLocker lock(&sFFTWPlanMutex);
+    importFFTWisdom();
+    mPlan = fftw_plan_many_r2r(
+            1, &n, howMany,
+            mData, nullptr, 1, n,
+            mData, nullptr, 1, n,
+            &method, FFTW_EM_FLAG);
+}
+
+ReReFFTBatch::~ReReFFTBatch()
+{
+    QMutexLocker lock(&sFFTWPlanMutex);
+    fftw_free(mData);
+    fftw_destroy_plan(mPlan);
+}
+
+double *ReReFFTBatch::data(int row)
+{
+    return mData + row * mSize;
+}
+
+void ReReFFTBatch::compute()
+{
+    fftw_execute(mPlan);
+}
+
+int ReReFFTBatch::getLength() const
+{
+    return mSize;
+}
+
+int ReReFFTBatch::getBatchSize() const
+{
+    return mHowMany;
+}
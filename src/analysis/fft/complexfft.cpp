@@ -1,4 +1,5 @@
 #include "fft.h"
+#include <algorithm>
 #include <stdexcept>
 
 using namespace Analysis;
@@ -33,6 +34,48 @@ std::dcomplex& ComplexFFT::data(int index)
     return std::cast_dcomplex(mData[index]);
 }
 
+BufferView<std::dcomplex> ComplexFFT::dataView()
+{
+    return { &std::cast_dcomplex(mData[0]), getLength() };
+}
+
+void ComplexFFT::fillData(const double *x, int n, const double *window)
+{
+    if (n > 0)
+        checkIndex(n - 1);
+    if (window != nullptr) {
+        for (int i = 0; i < n; ++i) {
+            mData[i][0] = x[i] * window[i];
+            mData[i][1] = 0.0;
+        }
+    }
+    else {
+        for (int i = 0; i < n; ++i) {
+            mData[i][0] = x[i];
+            mData[i][1] = 0.0;
+        }
+    }
+    double *flat = &mData[0][0];
+    std::fill(flat + 2 * n, flat + 2 * mSize, 0.0);
+}
+
+void ComplexFFT::fillData(const std::dcomplex *x, int n)
+{
+    if (n > 0)
+        checkIndex(n - 1);
+    std::dcomplex *z = &std::cast_dcomplex(mData[0]);
+    std::copy(x, x + n, z);
+    std::fill(z + n, z + mSize, 0.0);
+}
+
+void ComplexFFT::copyData(std::dcomplex *out, int n) const
+{
+    if (n > 0)
+        checkIndex(n - 1);
+    const std::dcomplex *z = &std::cast_dcomplex(mData[0]);
+    std::copy(z, z + n, out);
+}
+
 void ComplexFFT::computeForward()
 {
     fftw_execute(mPlanForward);
@@ -48,9 +91,13 @@ int ComplexFFT::getLength() const
     return mSize;
 }
 
-void ComplexFFT::checkIndex(int index) const
+// Index checks are only compiled into debug builds.
+
+void ComplexFFT::checkIndex([[maybe_unused]] int index) const
 {
+#ifndef NDEBUG
     if (index < 0 || index >= getLength()) {
         throw std::runtime_error("FFT::ComplexFFT] Data array index out of range");
     }
+#endif
 }
@@ -4,7 +4,10 @@
 #include "rpcxx.h"
 #include <fftw3.h>
 #include <complex>
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
+#include <tuple>
 #include <QMutex>
 
 #if defined(EMSCRIPTEN)
@@ -34,6 +37,34 @@ namespace Analysis
 
     void importFFTWisdom();
 
+    // Pointer and length view of an FFTW buffer. Indexing is only bounds-checked in debug builds.
+    template<typename T>
+    class BufferView
+    {
+    public:
+        BufferView(T *data, int size) : mData(data), mSize(size) {}
+
+        T *data() const { return mData; }
+        int size() const { return mSize; }
+
+        T *begin() const { return mData; }
+        T *end() const { return mData + mSize; }
+
+        T& operator[](int index) const
+        {
+#ifndef NDEBUG
+            if (index < 0 || index >= mSize) {
+                throw std::runtime_error("FFT::BufferView] Index out of range");
+            }
+#endif
+            return mData[index];
+        }
+
+    private:
+        T *mData;
+        int mSize;
+    };
+
     class ReReFFT
     {
     public:
@@ -43,6 +74,12 @@ namespace Analysis
         double data(int index) const;
         double& data(int index);
 
+        BufferView<double> dataView();
+
+        // Copies n samples in, multiplied by window if given, and zero-pads the rest.
+        void fillData(const double *x, int n, const double *window = nullptr);
+        void copyData(double *out, int n) const;
+
         void compute();
 
         int getLength() const;
@@ -68,6 +105,14 @@ namespace Analysis
         std::dcomplex output(int index) const;
         std::dcomplex& output(int index);
 
+        BufferView<double> inputView();
+        BufferView<std::dcomplex> outputView();
+
+        // Copies n samples to the input, multiplied by window if given, and zero-pads the rest.
+        void fillInput(const double *x, int n, const double *window = nullptr);
+        void copyInput(double *out, int n) const;
+        void copyOutput(std::dcomplex *out, int n) const;
+
         void computeForward();
         void computeBackward();
 
@@ -94,6 +139,13 @@ namespace Analysis
 
         std::dcomplex data(int index) const;
         std::dcomplex& data(int index);
+
+        BufferView<std::dcomplex> dataView();
+
+        // Copies n samples in, real ones with a zero imaginary part, and zero-pads the rest.
+        void fillData(const double *x, int n, const double *window = nullptr);
+        void fillData(const std::dcomplex *x, int n);
+        void copyData(std::dcomplex *out, int n) const;
         
         void computeForward();
         void computeBackward();
@@ -110,7 +162,144 @@ namespace Analysis
         fftw_complex *mData;
     };
 
-    rpm::vector<double> fft_n(Analysis::RealFFT *fft, const rpm::vector<double>& signal, rpm::map<int, rpm::vector<double>>& windowCache);
+    // howMany transforms of the same length over contiguous rows, run by a single FFTW plan.
+    // Rows are accessed through pointers, without bounds checks.
+    class RealFFTBatch
+    {
+    public:
+        RealFFTBatch(int n, int howMany);
+        ~RealFFTBatch();
+
+        double *input(int row);
+        std::dcomplex *output(int row);
+
+        void computeForward();
+
+        int getInputLength() const;
+        int getOutputLength() const;
+        int getBatchSize() const;
+
+    private:
+        int mSize;
+        int mHowMany;
+        fftw_plan mPlanForward;
+
+        double *mIn;
+        fftw_complex *mOut;
+    };
+
+    class ReReFFTBatch
+    {
+    public:
+        ReReFFTBatch(int n, int howMany, fftw_r2r_kind method);
+        ~ReReFFTBatch();
+
+        double *data(int row);
+
+        void compute();
+
+        int getLength() const;
+        int getBatchSize() const;
+
+    private:
+        int mSize;
+        int mHowMany;
+        fftw_plan mPlan;
+
+        double *mData;
+    };
+
+    enum class SpectralWindow {
+        Rectangular,
+        BlackmanHarris,
+    };
+
+    // One windowed real FFT of a frame. The power spectrum and the autocorrelation
+    // derived from it are only computed on first use.
+    class SpectralFrame
+    {
+    public:
+        SpectralFrame(int nfft);
+
+        // Transforms n <= nfft samples, multiplied by window if given, zero-padded to nfft.
+        void compute(const double *x, int n, const double *window);
+
+        // |X[k]|^2 for the nfft / 2 + 1 bins.
+        const rpm::vector<double>& powerSpectrum();
+        // Circular autocorrelation of the windowed frame at the nfft lags.
+        const rpm::vector<double>& autocorrelation();
+
+        int getLength() const;
+
+    private:
+        RealFFT mFFT;
+        rpm::vector<double> mPower;
+        rpm::vector<double> mAutocorrelation;
+        bool mHasPower;
+        bool mHasAutocorrelation;
+    };
+
+    // Spectral frames shared between the consumers of one hop, keyed by (sample rate, size, length,
+    // window). Consumers asking for the same key within a hop read the same latest samples, so each
+    // frame is transformed at most once per hop without looking at the samples. Frames not asked
+    // for in staleHops hops are dropped.
+    class SpectralFrames
+    {
+    public:
+        SpectralFrames();
+
+        // Starts the next hop, after which every frame is transformed again on first use.
+        void nextHop();
+
+        SpectralFrame& get(double sampleRate, int nfft, SpectralWindow window, const double *x, int n);
+
+    private:
+        static constexpr uint64_t staleHops = 1024;
+
+        using Key = std::tuple<double, int, int, SpectralWindow>;
+
+        struct Entry {
+            std::unique_ptr<SpectralFrame> frame;
+            uint64_t hop;
+        };
+
+        rpm::map<Key, Entry> mFrames;
+        uint64_t mHop;
+    };
+
+    // Spectrum of the last n samples, updated by a sliding DFT: each new sample moves the
+    // n / 2 + 1 bins along in O(n) instead of transforming the whole frame again.
+    // The periodic Hann window is applied afterwards as a 3-tap kernel across the bins.
+    class SlidingDFT
+    {
+    public:
+        SlidingDFT(int n);
+
+        void push(const double *x, int count);
+        void reset();
+
+        // |Y[k]|^2 of the Hann-windowed frame for the n / 2 + 1 bins.
+        void powerSpectrum(double *out) const;
+
+        int getLength() const;
+        int getOutputLength() const;
+
+    private:
+        void resync();
+
+        RealFFT mFFT;
+        rpm::vector<double> mHistory;
+        int mPos;
+        int mSinceSync;
+        int mFullThreshold;
+
+        rpm::vector<double> mRe;
+        rpm::vector<double> mIm;
+        rpm::vector<double> mCos;
+        rpm::vector<double> mSin;
+    };
+
+    rpm::vector<double> fft_n(Analysis::RealFFT *fft, const rpm::vector<double>& signal);
 }
 
 #endif // ANALYSIS_FFT_H
@@ -1,4 +1,6 @@
 #include "fft.h"
+#include "../simd/simd.h"
+#include <algorithm>
 #include <stdexcept>
 
 using namespace Analysis;
@@ -49,6 +51,44 @@ std::dcomplex& RealFFT::output(int index)
     return std::cast_dcomplex(mOut[index]);
 }
 
+BufferView<double> RealFFT::inputView()
+{
+    return { mIn, getInputLength() };
+}
+
+BufferView<std::dcomplex> RealFFT::outputView()
+{
+    return { &std::cast_dcomplex(mOut[0]), getOutputLength() };
+}
+
+void RealFFT::fillInput(const double *x, int n, const double *window)
+{
+    if (n > 0)
+        checkInputIndex(n - 1);
+    if (window != nullptr) {
+        SIMD::multiply(x, window, mIn, n);
+    }
+    else {
+        std::copy(x, x + n, mIn);
+    }
+    std::fill(mIn + n, mIn + mSize, 0.0);
+}
+
+void RealFFT::copyInput(double *out, int n) const
+{
+    if (n > 0)
+        checkInputIndex(n - 1);
+    std::copy(mIn, mIn + n, out);
+}
+
+void RealFFT::copyOutput(std::dcomplex *out, int n) const
+{
+    if (n > 0)
+        checkOutputIndex(n - 1);
+    const std::dcomplex *z = &std::cast_dcomplex(mOut[0]);
+    std::copy(z, z + n, out);
+}
+
 void RealFFT::computeForward()
 {
     fftw_execute(mPlanForward);
@@ -69,16 +109,22 @@ int RealFFT::getOutputLength() const
     return mSize / 2 + 1;
 }
 
-void RealFFT::checkInputIndex(int index) const
+// Index checks are only compiled into debug builds.
+
+void RealFFT::checkInputIndex([[maybe_unused]] int index) const
 {
+#ifndef NDEBUG
     if (index < 0 || index >= getInputLength()) {
         throw std::runtime_error("FFT::RealFFT] Input array index out of range");
     }
+#endif
 }
 
-void RealFFT::checkOutputIndex(int index) const
+void RealFFT::checkOutputIndex([[maybe_unused]] int index) const
 {
+#ifndef NDEBUG
     if (index < 0 || index >= getOutputLength()) {
         throw std::runtime_error("FFT::RealFFT] Output array index out of range");
     }
+#endif
 }
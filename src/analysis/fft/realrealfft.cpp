@@ -1,4 +1,6 @@
 #include "fft.h"
+#include "../simd/simd.h"
+#include <algorithm>
 #include <stdexcept>
 
 using namespace Analysis;
@@ -31,6 +33,31 @@ double& ReReFFT::data(int index)
     return mData[index];
 }
 
+BufferView<double> ReReFFT::dataView()
+{
+    return { mData, getLength() };
+}
+
+void ReReFFT::fillData(const double *x, int n, const double *window)
+{
+    if (n > 0)
+        checkIndex(n - 1);
+    if (window != nullptr) {
+        SIMD::multiply(x, window, mData, n);
+    }
+    else {
+        std::copy(x, x + n, mData);
+    }
+    std::fill(mData + n, mData + mSize, 0.0);
+}
+
+void ReReFFT::copyData(double *out, int n) const
+{
+    if (n > 0)
+        checkIndex(n - 1);
+    std::copy(mData, mData + n, out);
+}
+
 void ReReFFT::compute()
 {
     fftw_execute(mPlan);
@@ -41,10 +68,14 @@ int ReReFFT::getLength() const
     return mSize;
 }
 
-void ReReFFT::checkIndex(int index) const
+// Index checks are only compiled into debug builds.
+
+void ReReFFT::checkIndex([[maybe_unused]] int index) const
 {
+#ifndef NDEBUG
     if (index < 0 || index >= getLength()) {
-        throw std::runtime_error("FFT::RealFFT] Data array index out of range");
+        throw std::runtime_error("FFT::ReReFFT] Data array index out of range");
     }
+#endif
 }
 
@@ -0,0 +1,130 @@
+#include "fft.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Analysis;
+
+SlidingDFT::SlidingDFT(int n)
+    : mFFT(n),
+      mHistory(n, 0.0),
+      mPos(0),
+      mSinceSync(0),
+      mRe(n / 2 + 1, 0.0),
+      mIm(n / 2 + 1, 0.0),
+      mCos(n / 2 + 1),
+      mSin(n / 2 + 1)
+{
+    if (n < 4 || n % 2 != 0) {
+        throw std::runtime_error("FFT::SlidingDFT] Length must be even and at least 4");
+    }
+
+    // Past about log2(n) new samples per push, one full transform is cheaper than sliding.
+    mFullThreshold = 1;
+    while ((1 << mFullThreshold) < n)
+        mFullThreshold++;
+
+    for (int k = 0; k <= n / 2; ++k) {
+        const double theta = (2.0 * M_PI * k) / n;
+        mCos[k] = cos(theta);
+        mSin[k] = sin(theta);
+    }
+}
+
+void SlidingDFT::push(const double *x, int count)
+{
+    const int n = getLength();
+    const int m = getOutputLength();
+
+    if (count >= mFullThreshold) {
+        if (count > n) {
+            x += count - n;
+            count = n;
+        }
+        for (int i = 0; i < count; ++i) {
+            mHistory[mPos] = x[i];
+            mPos = (mPos + 1 == n) ? 0 : mPos + 1;
+        }
+        resync();
+        return;
+    }
+
+    double *re = mRe.data();
+    double *im = mIm.data();
+    const double *c = mCos.data();
+    const double *s = mSin.data();
+
+    // X[k] <- (X[k] + x[new] - x[old]) e^(j 2 pi k / n)
+    for (int i = 0; i < count; ++i) {
+        const double delta = x[i] - mHistory[mPos];
+        mHistory[mPos] = x[i];
+        mPos = (mPos + 1 == n) ? 0 : mPos + 1;
+
+        for (int k = 0; k < m; ++k) {
+            const double a = re[k] + delta;
+            const double b = im[k];
+            re[k] = a * c[k] - b * s[k];
+            im[k] = a * s[k] + b * c[k];
+        }
+    }
+
+    // Rounding errors in the recursion accumulate, so the bins are recomputed every n samples.
+    mSinceSync += count;
+    if (mSinceSync >= n) {
+        resync();
+    }
+}
+
+void SlidingDFT::reset()
+{
+    std::fill(mHistory.begin(), mHistory.end(), 0.0);
+    std::fill(mRe.begin(), mRe.end(), 0.0);
+    std::fill(mIm.begin(), mIm.end(), 0.0);
+    mPos = 0;
+    mSinceSync = 0;
+}
+
+void SlidingDFT::resync()
+{
+    const int n = getLength();
+
+    auto in = mFFT.inputView();
+    std::copy(mHistory.begin() + mPos, mHistory.end(), in.begin());
+    std::copy(mHistory.begin(), mHistory.begin() + mPos, in.begin() + (n - mPos));
+
+    mFFT.computeForward();
+
+    const auto out = mFFT.outputView();
+    for (int k = 0; k < out.size(); ++k) {
+        mRe[k] = out[k].real();
+        mIm[k] = out[k].imag();
+    }
+
+    mSinceSync = 0;
+}
+
+void SlidingDFT::powerSpectrum(double *out) const
+{
+    const int m = getOutputLength();
+
+    // Y[k] = X[k] / 2 - (X[k - 1] + X[k + 1]) / 4, with X[-k] = conj(X[k]) past either end.
+    for (int k = 0; k < m; ++k) {
+        const int lo = (k > 0) ? k - 1 : 1;
+        const int hi = (k < m - 1) ? k + 1 : m - 2;
+        const double loIm = (k > 0) ? mIm[lo] : -mIm[lo];
+        const double hiIm = (k < m - 1) ? mIm[hi] : -mIm[hi];
+
+        const double yr = 0.5 * mRe[k] - 0.25 * (mRe[lo] + mRe[hi]);
+        const double yi = 0.5 * mIm[k] - 0.25 * (loIm + hiIm);
+        out[k] = yr * yr + yi * yi;
+    }
+}
+
+int SlidingDFT::getLength() const
+{
+    return (int) mHistory.size();
+}
+
+int SlidingDFT::getOutputLength() const
+{
+    return (int) mRe.size();
+}
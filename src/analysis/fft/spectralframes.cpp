@@ -0,0 +1,102 @@
+#include "fft.h"
+#include "../window/window.h"
+#include <algorithm>
+
+using namespace Analysis;
+
+SpectralFrame::SpectralFrame(int nfft)
+    : mFFT(nfft),
+      mHasPower(false),
+      mHasAutocorrelation(false)
+{
+}
+
+void SpectralFrame::compute(const double *x, int n, const double *window)
+{
+    if (n > mFFT.getInputLength()) {
+        throw std::runtime_error("FFT::SpectralFrame] Frame longer than the transform");
+    }
+
+    mFFT.fillInput(x, n, window);
+    mFFT.computeForward();
+
+    mHasPower = false;
+    mHasAutocorrelation = false;
+}
+
+const rpm::vector<double>& SpectralFrame::powerSpectrum()
+{
+    if (!mHasPower) {
+        const auto out = mFFT.outputView();
+        mPower.resize(out.size());
+        for (int k = 0; k < out.size(); ++k) {
+            mPower[k] = std::norm(out[k]);
+        }
+        mHasPower = true;
+    }
+    return mPower;
+}
+
+const rpm::vector<double>& SpectralFrame::autocorrelation()
+{
+    if (!mHasAutocorrelation) {
+        // The inverse transform overwrites the spectrum, so the power is kept aside first.
+        const auto& power = powerSpectrum();
+        const int nfft = mFFT.getInputLength();
+
+        auto out = mFFT.outputView();
+        for (int k = 0; k < out.size(); ++k) {
+            out[k] = power[k] / (double) nfft;
+        }
+        mFFT.computeBackward();
+
+        mAutocorrelation.resize(nfft);
+        mFFT.copyInput(mAutocorrelation.data(), nfft);
+        mHasAutocorrelation = true;
+    }
+    return mAutocorrelation;
+}
+
+int SpectralFrame::getLength() const
+{
+    return mFFT.getInputLength();
+}
+
+SpectralFrames::SpectralFrames()
+    : mHop(0)
+{
+}
+
+void SpectralFrames::nextHop()
+{
+    mHop++;
+
+    for (auto it = mFrames.begin(); it != mFrames.end(); ) {
+        if (mHop - it->second.hop > staleHops) {
+            it = mFrames.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+SpectralFrame& SpectralFrames::get(double sampleRate, int nfft, SpectralWindow window, const double *x, int n)
+{
+    auto& entry = mFrames[Key(sampleRate, nfft, n, window)];
+    if (!entry.frame) {
+        entry.frame = std::make_unique<SpectralFrame>(nfft);
+    }
+    else if (entry.hop == mHop) {
+        return *entry.frame;
+    }
+
+    const double *w = nullptr;
+    if (window == SpectralWindow::BlackmanHarris) {
+        w = getWindow(WindowType::BlackmanHarris, n).data();
+    }
+
+    entry.frame->compute(x, n, w);
+    entry.hop = mHop;
+    return *entry.frame;
+}
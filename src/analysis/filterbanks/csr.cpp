@@ -0,0 +1,33 @@
+#include "filterbanks.h"
+#include "../simd/simd.h"
+
+using namespace Analysis;
+
+CSRFilterbank::CSRFilterbank(const Eigen::SparseMatrix<double>& filterbank)
+    : mBinCount((int) filterbank.cols())
+{
+    Eigen::SparseMatrix<double, Eigen::RowMajor> rows = filterbank;
+    rows.makeCompressed();
+
+    const int bandCount = (int) rows.rows();
+    const int nonZeros = (int) rows.nonZeros();
+
+    mRowStart.assign(rows.outerIndexPtr(), rows.outerIndexPtr() + bandCount + 1);
+    mColumns.assign(rows.innerIndexPtr(), rows.innerIndexPtr() + nonZeros);
+    mValues.assign(rows.valuePtr(), rows.valuePtr() + nonZeros);
+}
+
+void CSRFilterbank::apply(const double *spectrum, double *bands) const
+{
+    SIMD::sparseMatVec(mRowStart.data(), mColumns.data(), mValues.data(), getBandCount(), spectrum, bands);
+}
+
+int CSRFilterbank::getBandCount() const
+{
+    return (int) mRowStart.size() - 1;
+}
+
+int CSRFilterbank::getBinCount() const
+{
+    return mBinCount;
+}
@@ -1,6 +1,7 @@
 #ifndef ANALYSIS_FILTERBANKS_H
 #define ANALYSIS_FILTERBANKS_H
 
+#include "rpcxx.h"
 #include <Eigen/Sparse>
 #include <cmath>
 #include <functional>
@@ -15,6 +16,24 @@ namespace Analysis {
 
     Eigen::SparseMatrix<double> erbFilterbank(double minFreqHz, double maxFreqHz, int erbBinCount, int linearBinCount, double sampleRateHz);
 
+    // Row-compressed (CSR) copy of a filterbank, for applying it to one spectrum after another.
+    class CSRFilterbank {
+    public:
+        CSRFilterbank(const Eigen::SparseMatrix<double>& filterbank);
+
+        // bands[b] = sum over k of filterbank(b, k) * spectrum[k].
+        void apply(const double *spectrum, double *bands) const;
+
+        int getBandCount() const;
+        int getBinCount() const;
+
+    private:
+        int mBinCount;
+        rpm::vector<int> mRowStart;
+        rpm::vector<int> mColumns;
+        rpm::vector<double> mValues;
+    };
+
 }
 
 inline double hz2mel(double f) {
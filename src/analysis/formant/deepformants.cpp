@@ -9,33 +9,76 @@ using Analysis::FormantResult;
 
 using namespace Eigen;
 
+static constexpr int featureCount = DFModelHolder::featureCount;
+static constexpr int outputCount = DFModelHolder::outputCount;
+
+static void fillResult(const float *output, FormantResult& formantResult)
+{
+    formantResult.formants.clear();
+    for (int i = 0; i < outputCount; ++i) {
+        formantResult.formants.push_back({
+            1000.0 * output[i],
+            80,
+        });
+    }
+}
+
+DeepFormants::DeepFormants()
+    : mPlans(new DFFeaturePlans),
+      mQueued(0)
+{
+}
+
+DeepFormants::~DeepFormants()
+{
+    delete mPlans;
+}
+
 void DeepFormants::setFrameAudio(const rpm::vector<double>& x)
 {
     xv = x;
 }
 
-FormantResult DeepFormants::solve(const double *, int, double)
+void DeepFormants::computeFeatures(const rpm::vector<double>& x, float *row)
+{
+    Map<const ArrayXd> xm(x.data(), x.size());
+    Map<ArrayXf>(row, featureCount) = build_feature_row(xm, *mPlans).cast<float>();
+}
+
+void DeepFormants::solve(const double *, int, double, FormantResult& formantResult)
 {
-    Map<const ArrayXd> x(xv.data(), xv.size());
+    float row[featureCount];
+    computeFeatures(xv, row);
 
-    ArrayXd features = build_feature_row(x);
-    
-    torch::Tensor input = torch::ones({1, 350});
-    for (int i = 0; i < 350; ++i) {
-        input[0][i] = features(i);
-    }
+    float output[outputCount];
+    DFModelHolder::instance()->forward(row, 1, output);
 
-    torch::Tensor output = DFModelHolder::instance()->torchModule()->forward({input}).toTensor();
+    fillResult(output, formantResult);
+}
 
-    ArrayXd result = Map<ArrayXf>(output.data_ptr<float>(), output.size(1)).cast<double>();
+void DeepFormants::queueFrameAudio(const rpm::vector<double>& x)
+{
+    mFeatures.resize((mQueued + 1) * featureCount);
+    computeFeatures(x, mFeatures.data() + mQueued * featureCount);
+    mQueued++;
+}
 
-    FormantResult formantResult;
-    for (int i = 0; i < 4; ++i) {
-        formantResult.formants.push_back({
-            1000 * result(i),
-            80,
-        });
+int DeepFormants::queuedFrameCount() const
+{
+    return mQueued;
+}
+
+void DeepFormants::solveQueued(FormantResult *results)
+{
+    if (mQueued == 0) {
+        return;
     }
 
-    return formantResult;
+    mOutputs.resize(mQueued * outputCount);
+    DFModelHolder::instance()->forward(mFeatures.data(), mQueued, mOutputs.data());
+
+    for (int i = 0; i < mQueued; ++i) {
+        fillResult(mOutputs.data() + i * outputCount, results[i]);
+    }
+    mQueued = 0;
 }
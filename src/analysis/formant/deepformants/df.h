@@ -15,36 +15,48 @@
 #define slots Q_SLOTS
 
 #include "../../fft/fft.h"
+#include <memory>
 
 #define MAX_AMPLITUDE_16BIT (32767.0)
 
+// Batched plans for the feature pipeline, rebuilt when the length or the number of rows
+// changes. Each solver owns its own set, so sessions can build features concurrently.
+struct DFFeaturePlans {
+public:
+    Analysis::ReReFFTBatch *dct(int n, int howMany);
+    Analysis::RealFFTBatch *fft1(int n, int howMany);
+    Analysis::RealFFTBatch *fft2(int n, int howMany);
+
+private:
+    std::unique_ptr<Analysis::ReReFFTBatch> mDct;
+    std::unique_ptr<Analysis::RealFFTBatch> mFft1;
+    std::unique_ptr<Analysis::RealFFTBatch> mFft2;
+};
+
 template<typename Derived>
-Eigen::ArrayXd build_feature_row(const Eigen::ArrayBase<Derived>& x);
+Eigen::ArrayXd build_feature_row(const Eigen::ArrayBase<Derived>& x, DFFeaturePlans& plans);
 
 struct DFModelHolder {
 public:
+    static constexpr int featureCount = 350;
+    static constexpr int outputCount = 4;
+
     DFModelHolder();
 
     torch::jit::script::Module *torchModule();
 
-    Analysis::ReReFFT *dct(int n);
-    Analysis::RealFFT *fft1(int n);
-    Analysis::RealFFT *fft2(int n);
+    // Runs count feature rows (row-major, featureCount floats each) through the model
+    // in a single forward pass and writes outputCount values per row to out.
+    void forward(const float *features, int count, float *out);
+
+    // Sets the number of intra-op threads libtorch uses. Values below 1 keep its default.
+    void setNumThreads(int n);
 
     static DFModelHolder *instance();
     static void initialize(DFModelHolder **pptr);
 
 private:
     torch::jit::script::Module mTorchModule;
-    
-    int mDctN;
-    std::unique_ptr<Analysis::ReReFFT> mDct;
-
-    int mFft1N;
-    std::unique_ptr<Analysis::RealFFT> mFft1;
-
-    int mFft2N;
-    std::unique_ptr<Analysis::RealFFT> mFft2;
 
     static DFModelHolder *sInstance;
 };
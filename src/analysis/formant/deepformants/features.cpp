@@ -1,214 +1,172 @@
 #include "df.h"
 #include "../../fft/fft.h"
 #include "../../linpred/linpred.h"
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 using namespace Eigen;
 
-template<typename Derived>
-static ArrayXd dct(const ArrayBase<Derived>& x, int trunc)
-{
-    const int N = x.size();
-    
-    auto dct = DFModelHolder::instance()->dct(N);
+constexpr int ncep_ar = 30;
+constexpr int ncep_ps = 50;
 
-    for (int i = 0; i < N; ++i) {
-        dct->data(i) = x(i);
-    }
-    dct->compute();
+constexpr int nfft_ar = 4096;
+constexpr int nfft_ps = 4096;
+
+constexpr int pn_ar = nfft_ar / 2 + 1;
+constexpr int pn_ps = nfft_ps / 2 + 1;
 
-    ArrayXd out(trunc);
-    out(0) = dct->data(0) / sqrt(4 * N);
-    for (int i = 1; i < trunc; ++i) {
-        out(i) = dct->data(i);
+constexpr double epsilon = 1e-10;
+
+static_assert(pn_ar == pn_ps, "The spectra share one batched DCT.");
+
+Analysis::ReReFFTBatch *DFFeaturePlans::dct(int n, int howMany)
+{
+    if (!mDct || mDct->getLength() != n || mDct->getBatchSize() != howMany) {
+        mDct.reset(new Analysis::ReReFFTBatch(n, howMany, FFTW_REDFT10));
     }
-    return out;
+    return mDct.get();
 }
 
-template<typename Derived>
-static ArrayXd feature_periodogram(const ArrayBase<Derived>& x, int nfft)
+Analysis::RealFFTBatch *DFFeaturePlans::fft1(int n, int howMany)
 {
-    const int N = x.size();
-
-    auto fft = DFModelHolder::instance()->fft1(nfft);
-    
-    if (N < nfft) {
-        for (int i = 0; i < nfft; ++i)
-            fft->input(i) = 0.0;
-        for (int i = 0; i < N; ++i) 
-            fft->input(nfft / 2 - N / 2 + i) = x(i);
-    }
-    else if (N > nfft) {
-        for (int i = 0; i < nfft; ++i) {
-            fft->input(i) = x(N / 2 - nfft / 2 + i);
-        }
-    }
-    else {
-        for (int i = 0; i < nfft; ++i) {
-            fft->input(i) = x(i);
-        }
+    if (!mFft1 || mFft1->getInputLength() != n || mFft1->getBatchSize() != howMany) {
+        mFft1.reset(new Analysis::RealFFTBatch(n, howMany));
     }
+    return mFft1.get();
+}
 
-    fft->computeForward();
-
-    int outLength = fft->getOutputLength();
-    ArrayXd out(outLength);
-    for (int i = 0; i < outLength; ++i) {
-        double px = std::abs(fft->output(i));
-        out(i) = (px * px) / N;
+Analysis::RealFFTBatch *DFFeaturePlans::fft2(int n, int howMany)
+{
+    if (!mFft2 || mFft2->getInputLength() != n || mFft2->getBatchSize() != howMany) {
+        mFft2.reset(new Analysis::RealFFTBatch(n, howMany));
     }
-    return out;
+    return mFft2.get();
 }
 
+// log(s) where s is positive, epsilon where it is zero, NaN otherwise.
 template<typename Derived>
-static ArrayXd feature_arspec(const ArrayBase<Derived>& x, int order, int nfft)
+static auto logSpectrum(const ArrayBase<Derived>& s)
 {
-    Analysis::LP::Autocorr lpc;
-    double e;
-    rpm::vector<double> xv(x.size());
-    for (int i = 0; i < x.size(); ++i)
-        xv[i] = x(i);
-    auto a = lpc.solve(xv.data(), xv.size(), order, &e);
+    return (s > 0.0).select(s.log(), (s == 0.0).select(ArrayXd::Constant(s.size(), epsilon), NAN));
+}
 
-    auto fft = DFModelHolder::instance()->fft2(nfft);
+// Averaged periodogram of samps consecutive sub-frames, all transformed by one batched plan.
+template<typename Derived>
+static void specPS(const ArrayBase<Derived>& x, int pitch, const ArrayXd& freqs, DFFeaturePlans& plans,
+        double *out)
+{
+    constexpr int nfft = nfft_ps;
+    constexpr int pn = pn_ps;
 
-    fft->input(0) = 1.0;
-    for (int i = 1; i <= a.size(); ++i) 
-        fft->input(i) = a[i - 1];
-    for (int i = a.size() + 1; i < nfft; ++i)
-        fft->input(i) = 0.0; 
+    int samps = x.size() / pitch;
+    if (samps == 0)
+        samps = 1;
+    const int N = x.size() / samps;
 
-    fft->computeForward();
+    auto fft = plans.fft1(nfft, samps);
 
-    int outLength = fft->getOutputLength();
-    ArrayXd out(outLength);
-    for (int i = 0; i < outLength; ++i) {
-        auto px = std::abs(1.0 / fft->output(i));
-        out(i) = px * px * e;
-    }
-    return out;
-}
+    for (int k = 0; k < samps; ++k) {
+        Map<ArrayXd> in(fft->input(k), nfft);
+        const auto seg = x.segment(k * N, N);
 
-template<typename Derived>
-static ArrayXd atal(const ArrayBase<Derived>& x, int order, int numCoefs)
-{
-    Analysis::LP::Autocorr lpc;
-    double e;
-    rpm::vector<double> xv(x.size());
-    for (int i = 0; i < x.size(); ++i)
-        xv[i] = x(i);
-    auto a = lpc.solve(xv.data(), xv.size(), order, &e);
-    int m, k, p = a.size();
-
-    ArrayXd c(numCoefs);
-    c.setZero();
-    
-    c(0) = 1.0;
-    for (m = 1; m < p + 1; ++m) {
-        c(m) = -a[m - 1];
-        for (k = 1; k < m; ++k)
-            c(m) += (double(k) / double(m) - 1) * a[k - 1] * c(m - k);
-    }
-    for (m = p + 1; m < numCoefs; ++m) {
-        c(m) = 0.0;
-        for (k = 1; k < p + 1; ++k)
-            c(m) += (double(k) / double(m) - 1) * a[k - 1] * c(m - k);
+        if (N < nfft) {
+            in.setZero();
+            in.segment(nfft / 2 - N / 2, N) = seg;
+        }
+        else {
+            in = seg.segment(N / 2 - nfft / 2, nfft);
+        }
     }
-    return c;
-}
 
-constexpr int ncep_ar = 30;
-constexpr int ncep_ps = 50;
+    fft->computeForward();
 
-constexpr int nfft_ar = 4096;
-constexpr int nfft_ps = 4096;
+    ArrayXd specs = ArrayXd::Zero(pn);
+    for (int k = 0; k < samps; ++k) {
+        specs += Map<const ArrayXcd>(fft->output(k), pn).abs2();
+    }
+    specs /= (double) N * samps;
 
-constexpr double epsilon = 1e-10;
+    Map<ArrayXd>(out, pn) = logSpectrum((specs.square() + freqs.square()).sqrt()).log10();
+}
 
-template<typename Derived>
-static ArrayXd arSpecs(const ArrayBase<Derived>& x, int order)
+// Power spectra e / |A|^2 of count AR polynomials (row p of a, stride, has order orders[p]),
+// all transformed by one batched plan.
+static void arSpecs(const double *a, int stride, const int *orders, const double *e, int count,
+        const ArrayXd& freqs, DFFeaturePlans& plans, double *out, int outStride)
 {
-    //return atal(x, order, ncep_ar);
-
     constexpr int nfft = nfft_ar;
-    constexpr int pn = nfft / 2 + 1;
+    constexpr int pn = pn_ar;
 
-    ArrayXd freqs = ArrayXd::LinSpaced(pn, 0, 0.5);
+    auto fft = plans.fft2(nfft, count);
 
-    ArrayXd ars = feature_arspec(x, order, nfft);
-    ArrayXd ar(pn);
-
-    for (int i = 0; i < pn; ++i) {
-        ar(i) = log(sqrt(ars(i) * ars(i) + freqs(i) * freqs(i)));
-        
-        if (ar(i) < 0.0)
-            ar(i) = NAN;
-        else if (ar(i) == 0.0)
-            ar(i) = epsilon;
+    for (int k = 0; k < count; ++k) {
+        double *in = fft->input(k);
+        const double *row = a + orders[k] * stride;
+        std::copy(row, row + orders[k] + 1, in);
+        std::fill(in + orders[k] + 1, in + nfft, 0.0);
     }
-   
-    return dct(log10(ar), ncep_ar);
-}
-
-template<typename Derived>
-static ArrayXd specPS(const ArrayBase<Derived>& x, int pitch)
-{
-    constexpr int nfft = nfft_ps;
-    constexpr int pn = nfft / 2 + 1;
 
-    ArrayXd freqs = ArrayXd::LinSpaced(pn, 0, 0.5);
+    fft->computeForward();
 
-    int samps = x.size() / pitch;
-    if (samps == 0)
-        samps = 1;
-    int frames = x.size() / samps;
+    for (int k = 0; k < count; ++k) {
+        const ArrayXd ars = e[orders[k]] / Map<const ArrayXcd>(fft->output(k), pn).abs2();
+        const ArrayXd ar = (ars.square() + freqs.square()).sqrt().log();
 
-    ArrayXd specs = feature_periodogram(x.head(frames), nfft);
-    for (int i = 1; i < samps; ++i) {
-        specs += feature_periodogram(x.segment(i * frames, frames), nfft);
-    }
-    specs /= (double) samps;
-
-    ArrayXd peri(pn);
-
-    for (int i = 0; i < pn; ++i) {
-        peri(i) = sqrt(specs(i) * specs(i) + freqs(i) * freqs(i));
-        if (peri(i) > 0.0)
-            peri(i) = log(peri(i));
-        else if (peri(i) == 0.0)
-            peri(i) = epsilon;
-        else
-            peri(i) = NAN;
+        Map<ArrayXd>(out + k * outStride, pn) =
+            (ar < 0.0).select(NAN, (ar == 0.0).select(ArrayXd::Constant(pn, epsilon), ar)).log10();
     }
-   
-    return dct(log10(peri), ncep_ps);
 }
 
 template<typename Derived>
-ArrayXd build_feature_row(const ArrayBase<Derived>& x)
+ArrayXd build_feature_row(const ArrayBase<Derived>& x, DFFeaturePlans& plans)
 {
-    const rpm::vector<int> lpcs{8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
-    
+    constexpr int lpcs[] = {8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+    constexpr int numLpcs = std::size(lpcs);
+    constexpr int maxOrder = 17;
+    constexpr int pn = pn_ps;
+
+    static const ArrayXd freqs = ArrayXd::LinSpaced(pn, 0, 0.5);
+
     // The feature things expect data in 16bit signed int format.
     ArrayXd input = x * MAX_AMPLITUDE_16BIT;
-    
-    ArrayXd arr(ncep_ps + lpcs.size() * ncep_ar);
 
-    arr.head(ncep_ps) = specPS(input, 50);
+    ArrayXd arr(ncep_ps + numLpcs * ncep_ar);
 
-    int start = ncep_ps;
-    for (int order : lpcs) {
-        arr.segment(start, ncep_ar) = arSpecs(input, order);
-        start += ncep_ar;
+    // Row 0 of the DCT batch takes the periodogram, rows 1 onwards the AR spectra.
+    auto dct = plans.dct(pn, 1 + numLpcs);
+
+    specPS(input, 50, freqs, plans, dct->data(0));
+
+    // One recursion yields the AR polynomials of every order.
+    double a[(maxOrder + 1) * (maxOrder + 1)];
+    double e[maxOrder + 1];
+    Analysis::LP::Autocorr lpc;
+    const int reached = lpc.solveAllOrders(input.data(), (int) input.size(), maxOrder, a, e);
+
+    int orders[numLpcs];
+    for (int k = 0; k < numLpcs; ++k) {
+        orders[k] = std::min(lpcs[k], reached);
     }
+    arSpecs(a, maxOrder + 1, orders, e, numLpcs, freqs, plans, dct->data(1), pn);
 
-    for (int i = 0; i < arr.size(); ++i) {
-        if (std::isnan(arr(i)))
-            arr(i) = 0.0;
+    dct->compute();
+
+    const double dcScale = 1.0 / sqrt(4 * pn);
+
+    arr.head(ncep_ps) = Map<const ArrayXd>(dct->data(0), ncep_ps);
+    arr(0) *= dcScale;
+
+    for (int k = 0; k < numLpcs; ++k) {
+        const int start = ncep_ps + k * ncep_ar;
+        arr.segment(start, ncep_ar) = Map<const ArrayXd>(dct->data(1 + k), ncep_ar);
+        arr(start) *= dcScale;
     }
 
+    arr = arr.isNaN().select(0.0, arr);
+
     return arr;
 }
 
 using ImplT = Map<const ArrayXd>;
-template ArrayXd build_feature_row<ImplT>(const ArrayBase<ImplT>& x);
+template ArrayXd build_feature_row<ImplT>(const ArrayBase<ImplT>& x, DFFeaturePlans& plans);
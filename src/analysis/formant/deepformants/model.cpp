@@ -1,42 +1,40 @@
 #include "df.h"
 #include <QFile>
+#include <algorithm>
 
 DFModelHolder *DFModelHolder::sInstance;
 
 DFModelHolder::DFModelHolder()
-    : mDctN(0), mFft1N(0), mFft2N(0)
 {
 }
 
-Analysis::ReReFFT *DFModelHolder::dct(int n)
-{
-    if (mDctN != n) {
-        mDct.reset(new Analysis::ReReFFT(n, FFTW_REDFT10));
-        mDctN = n;
-    }
-    return mDct.get();
+torch::jit::script::Module *DFModelHolder::torchModule() {
+    return &mTorchModule;
 }
 
-Analysis::RealFFT *DFModelHolder::fft1(int n)
+void DFModelHolder::forward(const float *features, int count, float *out)
 {
-    if (mFft1N != n) {
-        mFft1.reset(new Analysis::RealFFT(n));
-        mFft1N = n;
+    torch::NoGradGuard noGrad;
+
+    // Wraps the caller's rows without copying them.
+    torch::Tensor input = torch::from_blob(
+            const_cast<float *>(features), {count, featureCount}, torch::kFloat);
+
+    torch::Tensor output = mTorchModule.forward({input}).toTensor().contiguous();
+
+    const int n = std::min<int>(output.size(1), outputCount);
+    const float *result = output.data_ptr<float>();
+    for (int i = 0; i < count; ++i) {
+        std::copy(result + i * output.size(1), result + i * output.size(1) + n, out + i * outputCount);
+        std::fill(out + i * outputCount + n, out + (i + 1) * outputCount, 0.0f);
     }
-    return mFft1.get();
 }
 
-Analysis::RealFFT *DFModelHolder::fft2(int n)
+void DFModelHolder::setNumThreads(int n)
 {
-    if (mFft2N != n) {
-        mFft2.reset(new Analysis::RealFFT(n));
-        mFft2N = n;
+    if (n >= 1) {
+        at::set_num_threads(n);
     }
-    return mFft2.get();
-}
-
-torch::jit::script::Module *DFModelHolder::torchModule() {
-    return &mTorchModule;
 }
 
 DFModelHolder *DFModelHolder::instance() {
@@ -3,26 +3,34 @@
 #include "../util/aberth.h"
 #include "../fft/fft.h"
 #include <algorithm>
+#include <cmath>
 
 using namespace Analysis::Formant;
 using Analysis::FormantResult;
 
-static int cauchyIntegral(const rpm::vector<double>& p, double r1, double r2, double phi, int maxDepth);
+static int cauchyIntegral(const rpm::vector<double>& p, double r1, double r2, double phi, int maxDepth,
+        rpm::vector<double>& coefs);
 
-FormantResult FilteredLP::solve(const double *lpc, int lpcOrder, double sampleRate)
+void FilteredLP::solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result)
 {
-    rpm::vector<double> polynomial(lpcOrder + 1);
+    auto& polynomial = mPolynomial;
+    polynomial.resize(lpcOrder + 1);
     polynomial[0] = 1.0;
     std::copy(lpc, lpc + lpcOrder, std::next(polynomial.begin()));
 
-    rpm::vector<std::complex<double>> roots = findRoots(polynomial);
-    
-    struct FormantRoot {
-        FormantData d;
-        std::complex<double> r;
-    };
+    const auto& roots = mRootFinder.solve(polynomial);
+
+    // Each merged peak resolves to at most lpcOrder roots. Reserving for the bounds up front
+    // keeps the first frame that takes a new branch from allocating.
+    mPickedRoots.reserve(lpcOrder);
+    mMergedPeaks.reserve(lpcOrder);
+    mResolvedRoots.reserve(lpcOrder * lpcOrder);
+    mFormants.reserve(lpcOrder + lpcOrder * lpcOrder);
+    mExtraRoots.reserve(lpcOrder);
+    mClusterWork.reserve(lpcOrder);
 
-    rpm::vector<FormantRoot> pickedRoots;
+    auto& pickedRoots = mPickedRoots;
+    pickedRoots.clear();
 
     const double phiDelta = 2.0 * 50.0 * M_PI / sampleRate;
 
@@ -42,8 +50,11 @@ FormantResult FilteredLP::solve(const double *lpc, int lpcOrder, double sampleRa
     std::sort(pickedRoots.begin(), pickedRoots.end(),
             [](const auto& a, const auto& b) { return a.d.frequency < b.d.frequency; });
 
-    FormantResult result;
-    rpm::vector<FormantRoot> mergedPeaks;
+    auto& formants = mFormants;
+    formants.clear();
+
+    auto& mergedPeaks = mMergedPeaks;
+    mergedPeaks.clear();
 
     for (int i = 0; i < int(pickedRoots.size()) - 1; ++i) {
         if (pickedRoots[i + 1].d.frequency - pickedRoots[i].d.frequency > 700
@@ -51,14 +62,15 @@ FormantResult FilteredLP::solve(const double *lpc, int lpcOrder, double sampleRa
             mergedPeaks.push_back(pickedRoots[i]);
         }
         else {
-            result.formants.push_back(pickedRoots[i].d);
+            formants.push_back(pickedRoots[i].d);
         }
     }
     if (!pickedRoots.empty()) {
-        result.formants.push_back(pickedRoots.back().d);
+        formants.push_back(pickedRoots.back().d);
     }
 
-    rpm::vector<std::complex<double>> resolvedRoots;
+    auto& resolvedRoots = mResolvedRoots;
+    resolvedRoots.clear();
 
     for (const auto& v : mergedPeaks) {
         double phiPeak = std::arg(v.r);
@@ -72,13 +84,13 @@ FormantResult FilteredLP::solve(const double *lpc, int lpcOrder, double sampleRa
             phi3 = minPhi;
         }
 
-        int n3 = cauchyIntegral(polynomial, 0, 2, phi3, 100);
-        int n4 = cauchyIntegral(polynomial, 0, 2, phi4, 100);
+        int n3 = cauchyIntegral(polynomial, 0, 2, phi3, 100, mRayCoefs);
+        int n4 = cauchyIntegral(polynomial, 0, 2, phi4, 100, mRayCoefs);
 
         int n = std::abs(n4 - n3);
 
-        if (n >= 2) {
-            auto extraRoots = Analysis::aberthRootsAroundInitial(polynomial, 0.9, phiPeak, n);
+        auto& extraRoots = mExtraRoots;
+        if (n >= 2 && Analysis::aberthRootsAroundInitial(polynomial, 0.9, phiPeak, n, extraRoots, mClusterWork)) {
             resolvedRoots.insert(resolvedRoots.end(), extraRoots.begin(), extraRoots.end());
         }
         else {
@@ -95,119 +107,101 @@ FormantResult FilteredLP::solve(const double *lpc, int lpcOrder, double sampleRa
         if (r >= 0.6 && r < 1.0) {
             FormantData formant = calculateFormant(r, phi, sampleRate);
             if (formant.frequency > 50.0 && formant.frequency < sampleRate / 2 - 50.0) {
-                result.formants.push_back(std::move(formant));
+                formants.push_back(formant);
             }
         }
     }
 
-    sortFormants(result.formants);
+    sortFormants(formants);
 
-    return result;
-}
-
-static void snellCalcRegion(double t, rpm::map<double, int>& C, const rpm::vector<double>& p, double phi)
-{
-    // Do not calculate again.
-    if (C.find(t) == C.end()) {
-        std::complex<double> x = std::polar(t, phi);
-        std::complex<double> y, dy;
-        Analysis::evaluatePolynomialWithDerivative(p, x, &y, &dy);
-
-        // Find the octant it is in.
-        int Ci = static_cast<int>(16 + floor(std::arg(y) / (M_PI / 8.0))) % 8;
-        C[t] = Ci;
+    result.formants.clear();
+    for (const auto& formant : formants) {
+        result.formants.push_back(formant);
     }
 }
 
-static void snellCalcPartition(const rpm::vector<double>& t, rpm::map<double, int>& C, const rpm::vector<double>& p, double phi, int maxDepth, rpm::vector<double>& partition)
+// Net number of times P(t e^(j*phi)) winds counter-clockwise past the positive real axis
+// as t goes from r1 to r2, counted from the continuous change of its argument.
+// Along the ray P is a polynomial in t with complex coefficients c_k = p_k e^(j*k*phi),
+// so an initial grid is evaluated in one batch and intervals where the argument moves by
+// more than an eighth of a turn are bisected depth-first, up to maxDepth times.
+static int cauchyIntegral(const rpm::vector<double>& p, double r1, double r2, double phi, int maxDepth,
+        rpm::vector<double>& coefs)
 {
-    rpm::vector<std::pair<double, double>> partNext;
-    rpm::vector<std::pair<double, double>> partCurrent;
-    for (int i = 0; i < signed(t.size()) - 1; ++i) {
-        partCurrent.emplace_back(t[i], t[i + 1]);
+    constexpr int grid = 32;
+    constexpr int maxStack = 64;
+    constexpr double maxStep = M_PI / 4.0;
+
+    const int degree = (int) p.size() - 1;
+    maxDepth = std::min(maxDepth, maxStack - 2);
+
+    coefs.resize(2 * (degree + 1));
+    double *cRe = coefs.data();
+    double *cIm = cRe + degree + 1;
+
+    const std::complex<double> w = std::polar(1.0, phi);
+    std::complex<double> wk = 1.0;
+    for (int k = 0; k <= degree; ++k) {
+        cRe[k] = p[k] * wk.real();
+        cIm[k] = p[k] * wk.imag();
+        wk *= w;
     }
 
-    bool converged = false;
-    int depth = 0;
-
-    while (!converged) {
-        for (const auto &[t1, t2] : partCurrent) {
-            snellCalcRegion(t1, C, p, phi);
-            snellCalcRegion(t2, C, p, phi);
-
-            int count = abs(C[t1] - C[t2]) % 8;
-            if (count <= 1) {
-                partNext.emplace_back(t1, t2);
-            } else {
-                double tmid = (t1 + t2) / 2.0;
-                partNext.emplace_back(t1, tmid);
-                partNext.emplace_back(tmid, t2);
-            }
+    auto evaluate = [&](double t) {
+        double re = cRe[degree], im = cIm[degree];
+        for (int k = degree - 1; k >= 0; --k) {
+            re = re * t + cRe[k];
+            im = im * t + cIm[k];
         }
+        return std::complex<double>(re, im);
+    };
 
-        depth++;
-        converged = depth > maxDepth || std::equal(partCurrent.begin(), partCurrent.end(), partNext.begin());
-        partCurrent = partNext;
-        partNext.resize(0);
-    }
-
-    partition.push_back(partCurrent.at(0).first);
-    for (const auto & [t1, t2] : partCurrent) {
-        (void) t1;
-
-        partition.push_back(t2);
+    double gridT[grid], gridRe[grid], gridIm[grid];
+    for (int i = 0; i < grid; ++i) {
+        gridT[i] = r1 + (r2 - r1) * (double) i / (double) (grid - 1);
+        gridRe[i] = cRe[degree];
+        gridIm[i] = cIm[degree];
     }
-}
-
-int cauchyIntegral(const rpm::vector<double>& p, double r1, double r2, double phi, int maxDepth)
-{
-    // Let C(t) denote the region containing the point P(te^(j*phi)).
-    // If ti, i = 0 to i = M is a partition of the ray (r1 -> r2),
-    // then p(ti, ti+1) denotes the number of octants (mod 8) between C(ti) and C(ti-1)
-
-    rpm::map<double, int> C; // Memoised counts for every value of t encountered.
-
-    constexpr int ipc = 7;
-    rpm::vector<double> initialPartition(ipc);
-    for (int i = 0; i < ipc; ++i) {
-        initialPartition[i] = r1 + (r2 - r1) * (double) i / (double) (ipc - 1);
+    for (int k = degree - 1; k >= 0; --k) {
+        for (int i = 0; i < grid; ++i) {
+            gridRe[i] = gridRe[i] * gridT[i] + cRe[k];
+            gridIm[i] = gridIm[i] * gridT[i] + cIm[k];
+        }
     }
 
-    rpm::vector<double> finalPartition;
-    snellCalcPartition(initialPartition, C, p, phi, maxDepth, finalPartition);
+    double start = std::arg(std::complex<double>(gridRe[0], gridIm[0]));
+    if (start < 0.0)
+        start += 2.0 * M_PI;
 
-    /*for (int i = 0; i < finalPartition.size(); ++i) {
-        double t = finalPartition[i];
-        std::cout << "C(" << t << ") = " << C[t] << std::endl;
-    }
-    std::cout << std::endl;*/
+    double total = 0.0;
 
-    // Calculate N+ and N-
-    //  N+ is the number of transitions from region C7 to region C0
-    //  N- is the number of transitions from region C0 to region C7
+    struct Node { double t; std::complex<double> y; int depth; };
+    Node stack[maxStack];
 
-    int Np = 0, Nm = 0;
+    for (int i = 0; i < grid - 1; ++i) {
+        double t1 = gridT[i];
+        std::complex<double> y1(gridRe[i], gridIm[i]);
 
-    for (int i = 0; i < signed(finalPartition.size()) - 1; ++i) {
-        double t1 = finalPartition[i];
-        double t2 = finalPartition[i + 1];
-        // Make sure all C values are calculated for the final partition.
-        snellCalcRegion(t1, C, p, phi);
-        snellCalcRegion(t2, C, p, phi);
+        int top = 0;
+        stack[top++] = { gridT[i + 1], { gridRe[i + 1], gridIm[i + 1] }, 0 };
 
-        int c1 = C[t1];
-        int c2 = C[t2];
+        while (top > 0) {
+            Node& right = stack[top - 1];
+            const double step = std::arg(right.y * std::conj(y1));
 
-        if (c1 == 7 && c2 == 0) {
-            Np++;
-        }
-        else if (c1 == 0 && c2 == 7) {
-            Nm++;
+            if (std::abs(step) <= maxStep || right.depth >= maxDepth) {
+                total += step;
+                t1 = right.t;
+                y1 = right.y;
+                --top;
+            }
+            else {
+                const double tmid = 0.5 * (t1 + right.t);
+                const int depth = ++right.depth;
+                stack[top++] = { tmid, evaluate(tmid), depth };
+            }
         }
     }
 
-    int N = Np - Nm;
-
-    return N;
+    return (int) std::floor((start + total) / (2.0 * M_PI));
 }
-
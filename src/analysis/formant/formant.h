@@ -3,6 +3,9 @@
 
 #include "rpcxx.h"
 #include "../../modules/audio/resampler/resampler.h"
+#include "../util/root_finder.h"
+#include <array>
+#include <complex>
 
 #ifdef ENABLE_TORCH
 
@@ -19,6 +22,8 @@ extern "C" void __assert_fail(const char* expr, const char *filename, unsigned i
 #pragma warning(pop)
 #define slots Q_SLOTS
 
+struct DFFeaturePlans;
+
 #endif
 
 namespace Analysis {
@@ -28,24 +33,86 @@ namespace Analysis {
         double bandwidth;
     };
 
+    // Fixed-capacity formant list stored inline, so that results never touch the heap.
+    // Formants pushed past the capacity are dropped.
+    class FormantList {
+    public:
+        static constexpr int capacity = 8;
+
+        FormantList() : mCount(0) {}
+
+        void clear() { mCount = 0; }
+        void push_back(const FormantData& formant) { if (mCount < capacity) mData[mCount++] = formant; }
+
+        int size() const { return mCount; }
+        bool empty() const { return mCount == 0; }
+
+        FormantData& operator[](int i) { return mData[i]; }
+        const FormantData& operator[](int i) const { return mData[i]; }
+
+        FormantData *begin() { return mData.data(); }
+        FormantData *end() { return mData.data() + mCount; }
+        const FormantData *begin() const { return mData.data(); }
+        const FormantData *end() const { return mData.data() + mCount; }
+
+    private:
+        std::array<FormantData, capacity> mData;
+        int mCount;
+    };
+
     struct FormantResult {
-        rpm::vector<FormantData> formants;
+        FormantList formants;
     };
 
     class FormantSolver {
     public:
-        virtual FormantResult solve(const double *lpc, int lpcOrder, double sampleRate) = 0;
+        virtual ~FormantSolver() {}
+
+        // Overwrites result. Solvers keep their scratch buffers between calls.
+        virtual void solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result) = 0;
+
+        FormantResult solve(const double *lpc, int lpcOrder, double sampleRate)
+        {
+            FormantResult result;
+            solve(lpc, lpcOrder, sampleRate, result);
+            return result;
+        }
     };
 
     namespace Formant {
         class SimpleLP : public FormantSolver {
         public:
-            FormantResult solve(const double *lpc, int lpcOrder, double sampleRate) override;
+            using FormantSolver::solve;
+            void solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result) override;
+
+            void setRootSolver(RootSolver solver) { mRootFinder.setSolver(solver); }
+        private:
+            RootFinder mRootFinder;
+            rpm::vector<double> mPolynomial;
+            rpm::vector<FormantData> mFormants;
         };
 
         class FilteredLP : public FormantSolver {
         public:
-            FormantResult solve(const double *lpc, int lpcOrder, double sampleRate) override;
+            using FormantSolver::solve;
+            void solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result) override;
+
+            void setRootSolver(RootSolver solver) { mRootFinder.setSolver(solver); }
+        private:
+            struct FormantRoot {
+                FormantData d;
+                std::complex<double> r;
+            };
+
+            RootFinder mRootFinder;
+            rpm::vector<double> mPolynomial;
+            rpm::vector<FormantRoot> mPickedRoots;
+            rpm::vector<FormantRoot> mMergedPeaks;
+            rpm::vector<std::complex<double>> mResolvedRoots;
+            rpm::vector<std::complex<double>> mExtraRoots;
+            rpm::vector<double> mRayCoefs;
+            AberthClusterWork mClusterWork;
+            rpm::vector<FormantData> mFormants;
         };
         
         struct KarmaState;
@@ -54,7 +121,8 @@ namespace Analysis {
         public:
             Karma();
             ~Karma();
-            FormantResult solve(const double *lpc, int lpcOrder, double sampleRate) override;
+            using FormantSolver::solve;
+            void solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result) override;
         private:
             KarmaState *state;
         };
@@ -62,11 +130,29 @@ namespace Analysis {
 #ifdef ENABLE_TORCH
         class DeepFormants : public FormantSolver {
         public:
-            FormantResult solve(const double *lpc, int lpcOrder, double sampleRate) override;
+            DeepFormants();
+            ~DeepFormants();
+
+            using FormantSolver::solve;
+            void solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result) override;
             void setFrameAudio(const rpm::vector<double>& x);
+
+            // Batch mode: frames are queued and then run through the model in one forward pass.
+            // solveQueued writes one result per queued frame and empties the queue.
+            void queueFrameAudio(const rpm::vector<double>& x);
+            int queuedFrameCount() const;
+            void solveQueued(FormantResult *results);
         private:
+            void computeFeatures(const rpm::vector<double>& x, float *row);
+
+            DFFeaturePlans *mPlans;
+
             rpm::vector<double> xv;
             double fs;
+
+            rpm::vector<float> mFeatures;
+            rpm::vector<float> mOutputs;
+            int mQueued;
         };
 #endif
     };
@@ -1,44 +1,50 @@
 #include "formant.h"
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
 
 using namespace Analysis::Formant;
 using Analysis::FormantResult;
 
 using namespace Eigen;
 
+constexpr int ncep = 15;
+constexpr int numF = 3;
+constexpr int numS = 2 * numF;
+
+using StateVector = Matrix<double, numS, 1>;
+using StateMatrix = Matrix<double, numS, numS>;
+using CepVector   = Matrix<double, ncep, 1>;
+using CepMatrix   = Matrix<double, ncep, ncep>;
+using ObsMatrix   = Matrix<double, ncep, numS>;
+
 struct Analysis::Formant::KarmaState
 {
-    int numF;
-    VectorXd y;
-    MatrixXd F;
-    MatrixXd Q;
-    MatrixXd R;
-    VectorXd m_up;
-    VectorXd P_up;
-};
+    StateMatrix F;
+    StateMatrix Q;
+    CepMatrix R;
+    StateVector m_up;
+    StateMatrix P_up;
 
-constexpr int ncep = 15;
-constexpr int numF = 3;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
 
 Karma::Karma()
     : state(new KarmaState)
 {
-    state->F.setIdentity(2 * numF, 2 * numF);
+    state->F.setIdentity();
+
+    state->Q.setZero();
+    state->Q.diagonal().head<numF>().setConstant(320 * 320);
+    state->Q.diagonal().tail<numF>().setConstant(100 * 100);
 
-    state->Q.setZero(2 * numF, 2 * numF);
-    state->Q.diagonal().head(numF).setConstant(320 * 320);
-    state->Q.diagonal().tail(numF).setConstant(100 * 100);
-    
-    state->R.setZero(ncep, ncep);
+    state->R.setZero();
     for (int i = 0; i < ncep; ++i) {
         state->R(i, i) = 1.0 / (double) (i + 1);
     }
 
-    VectorXd x0(2 * numF);
-    x0 << 500, 1500, 2500,
-           80,  120,  160;
-
-    state->m_up = x0;
+    state->m_up << 500, 1500, 2500,
+                    80,  120,  160;
     state->P_up = state->Q;
 }
 
@@ -47,104 +53,69 @@ Karma::~Karma()
     delete state;
 }
 
-static VectorXd calcCepstrumCoefs(const double *lpc, int lpcOrder, int ncep);
-static MatrixXd calcMatrixH(const VectorXd& m, int cepOrder, double Fs);
-static VectorXd calcCepstrumMapping(const VectorXd& m, int cepOrder, double Fs);
+static void calcCepstrumCoefs(const double *lpc, int lpcOrder, CepVector& C);
+static void calcCepstrumModel(const StateVector& m, double Fs, ObsMatrix& H, CepVector& y);
 
-FormantResult Karma::solve(const double *lpc, int lpcOrder, double sampleRate)
+void Karma::solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result)
 {
-    auto& F  = state->F;
-    auto  Ft = state->F.transpose();
-    auto& Q  = state->Q;
-    auto& R  = state->R;
+    const auto& F = state->F;
+    const auto& Q = state->Q;
+    const auto& R = state->R;
 
-    auto m_pred = F * state->m_up;
-    auto P_pred = F * state->P_up * Ft + Q;
+    const StateVector m_pred = F * state->m_up;
+    const StateMatrix P_pred = F * state->P_up * F.transpose() + Q;
 
-    auto H  = calcMatrixH(m_pred, ncep, sampleRate);
-    auto Ht = H.transpose();
-   
-    auto S = H * P_pred * Ht + R;
-    auto K = (P_pred * Ht) * S.colPivHouseholderQr().inverse();
+    ObsMatrix H;
+    CepVector y_pred;
+    calcCepstrumModel(m_pred, sampleRate, H, y_pred);
 
-    auto y_pred = calcCepstrumMapping(m_pred, ncep, sampleRate);
-    auto y      = calcCepstrumCoefs(lpc, lpcOrder, ncep);
+    CepVector y;
+    calcCepstrumCoefs(lpc, lpcOrder, y);
 
-    state->m_up = m_pred + K * (y - y_pred);
-    state->P_up = P_pred - K * H * P_pred;
+    // S and P are symmetric, so the transposed gain K' = S^-1 H P comes from a solve.
+    const ObsMatrix HP = H * P_pred;
+    const CepMatrix S = HP * H.transpose() + R;
+    const ObsMatrix Kt = S.ldlt().solve(HP);
 
-    rpm::vector<FormantData> formants(numF);
+    state->m_up.noalias() = m_pred + Kt.transpose() * (y - y_pred);
+    state->P_up.noalias() = P_pred - Kt.transpose() * HP;
+
+    result.formants.clear();
     for (int i = 0; i < numF; ++i) {
-        formants[i] = {
-            .frequency = state->m_up(i),
-            .bandwidth = state->m_up(numF + i),
-        };
+        result.formants.push_back({ state->m_up(i), state->m_up(numF + i) });
     }
-
-    return { .formants = formants };
 }
 
-VectorXd calcCepstrumCoefs(const double *lpc, int lpcOrder, int ncep)
+void calcCepstrumCoefs(const double *lpc, int lpcOrder, CepVector& C)
 {
-    VectorXd C(ncep);
-
     for (int n = 1; n <= ncep; ++n) {
-        if (n == 1) {
-            C(n - 1) = lpc[n - 1];
-        }
-        else if (n <= lpcOrder) {
-            C(n - 1) = lpc[n - 1];
-            for (int i = 1; i <= ncep - 1; ++i) {
-                C(n - 1) += (double) i / (double) n * lpc[n - i - 1] * C(i - 1);
-            }
-        }
-        else {
-            C(n - 1) = 0.0;
-            for (int i = ncep - lpcOrder; i <= ncep - 1; ++i) {
-                C(n - 1) += (double) i / (double) n * lpc[n - i - 1] * C(i - 1);
-            }
+        C(n - 1) = (n <= lpcOrder) ? lpc[n - 1] : 0.0;
+        for (int i = std::max(1, n - lpcOrder); i <= n - 1; ++i) {
+            C(n - 1) += (double) i / (double) n * lpc[n - i - 1] * C(i - 1);
         }
     }
-
-    return C;
 }
 
-MatrixXd calcMatrixH(const VectorXd &m, int cepOrder, double Fs)
+// Each formant contributes z^n with z = exp(-pi B / Fs) exp(2 pi i F / Fs) to cepstral coefficient n,
+// so the trig and exp terms are evaluated once per formant and the harmonics follow by rotation.
+void calcCepstrumModel(const StateVector& m, double Fs, ObsMatrix& H, CepVector& y)
 {
-    const int numF = m.size() / 2;
-    auto freq = m.segment(0, numF);
-    auto band = m.segment(numF, numF);
+    const Array<double, numF, 1> radius = (-M_PI / Fs * m.tail<numF>().array()).exp();
+    const Array<double, numF, 1> theta  = 2.0 * M_PI / Fs * m.head<numF>().array();
 
-    MatrixXd H(cepOrder, 2 * numF);
+    const Array<double, numF, 1> zRe = radius * theta.cos();
+    const Array<double, numF, 1> zIm = radius * theta.sin();
 
-    for (int i = 0; i < cepOrder; ++i) {
-        for (int j = 0; j < numF; ++j) {
-            const double bwTerm = exp((-M_PI * (i + 1) * band(j)) / Fs);
+    Array<double, numF, 1> re = zRe;
+    Array<double, numF, 1> im = zIm;
 
-            H(i, j)        = -4.0 * M_PI / Fs * bwTerm * sin((2.0 * M_PI * (i + 1) * freq(j)) / Fs);
-            H(i, numF + j) = -2.0 * M_PI / Fs * bwTerm * cos((2.0 * M_PI * (i + 1) * freq(j)) / Fs);
-        }
-    }
-
-    return H;
-}
-
-VectorXd calcCepstrumMapping(const VectorXd& m, int cepOrder, double Fs)
-{
-    const int numF = m.size() / 2;
-    auto freq = m.segment(0, numF);
-    auto band = m.segment(numF, numF);
-
-    VectorXd C_int(numF);
-    VectorXd C(cepOrder);
+    for (int i = 0; i < ncep; ++i) {
+        H.row(i).head<numF>() = (-4.0 * M_PI / Fs * im).matrix().transpose();
+        H.row(i).tail<numF>() = (-2.0 * M_PI / Fs * re).matrix().transpose();
+        y(i) = 2.0 / (double) (i + 1) * re.sum();
 
-    for (int i = 0; i < cepOrder; ++i) {
-        for (int p = 0; p < numF; ++p) {
-            const double bwTerm = (2.0 / (double) (i + 1)) * exp((-M_PI * (i + 1) * band(p)) / Fs);
-            C_int(p) = bwTerm * cos((2.0 * M_PI * (i + 1) * freq(p)) / Fs);
-        }
-        C(i) = C_int.sum();
+        const Array<double, numF, 1> nextRe = re * zRe - im * zIm;
+        im = re * zIm + im * zRe;
+        re = nextRe;
     }
-
-    return C;
 }
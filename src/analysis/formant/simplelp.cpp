@@ -4,15 +4,16 @@
 using namespace Analysis::Formant;
 using Analysis::FormantResult;
 
-FormantResult SimpleLP::solve(const double *lpc, int lpcOrder, double sampleRate)
+void SimpleLP::solve(const double *lpc, int lpcOrder, double sampleRate, FormantResult& result)
 {
-    rpm::vector<double> polynomial(lpcOrder + 1);
-    polynomial[0] = 1.0;
-    std::copy(lpc, lpc + lpcOrder, std::next(polynomial.begin()));
+    mPolynomial.resize(lpcOrder + 1);
+    mPolynomial[0] = 1.0;
+    std::copy(lpc, lpc + lpcOrder, std::next(mPolynomial.begin()));
     
-    rpm::vector<std::complex<double>> roots = findRoots(polynomial);
+    const auto& roots = mRootFinder.solve(mPolynomial);
 
-    FormantResult result;
+    mFormants.clear();
+    mFormants.reserve(lpcOrder);
 
     const double phiDelta = 2.0 * 50.0 * M_PI / sampleRate;
 
@@ -26,10 +27,13 @@ FormantResult SimpleLP::solve(const double *lpc, int lpcOrder, double sampleRate
             continue;
         }
 
-        result.formants.push_back(calculateFormant(r, phi, sampleRate));
+        mFormants.push_back(calculateFormant(r, phi, sampleRate));
     }
 
-    sortFormants(result.formants);
+    sortFormants(mFormants);
 
-    return result;
+    result.formants.clear();
+    for (const auto& formant : mFormants) {
+        result.formants.push_back(formant);
+    }
 }
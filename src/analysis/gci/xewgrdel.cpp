@@ -1,5 +1,6 @@
 #include "sigma.h"
 #include "../filter/filter.h"
+#include "../window/window.h"
 #include "../util/util.h"
 #include <limits>
 #include <algorithm>
@@ -12,11 +13,12 @@ SIGMA::xewgrdel(const rpm::vector<double>& u, double fs, double gwlen, double fw
     // Force window length to be odd.
     int gw = 2 * (int) std::round(gwlen * fs) / 2 + 1;
 
-    rpm::vector<double> ghw(gw);
+    // filter takes its coefficients as vectors, so the cached window is copied once here.
+    const auto hamming = Analysis::getWindow(Analysis::WindowType::Hamming, gw);
+    rpm::vector<double> ghw(hamming.begin(), hamming.end());
     rpm::vector<double> ghwn(gw);
 
     for (int i = 0, j = gw - 1; i < gw; ++i, j -= 2) {
-        ghw[i] = 0.54 + 0.46 * cos(2 * M_PI / (gw - 1) * i);
         ghwn[i] = ghw[i] * j / 2.0;
     }
 
@@ -44,11 +46,11 @@ SIGMA::xewgrdel(const rpm::vector<double>& u, double fs, double gwlen, double fw
     int fw = 2 * (int) std::round(fwlen * fs) / 2 + 1;
 
     if (fw > 1) {
-        rpm::vector<double> daw(fw);
+        const auto hamming = Analysis::getWindow(Analysis::WindowType::Hamming, fw);
+        rpm::vector<double> daw(hamming.begin(), hamming.end());
         double sum = 0.0;
 
         for (int i = 0; i < fw; ++i) {
-            daw[i] = 0.54 + 0.46 * cos(2 * M_PI / (fw - 1) * i);
             sum += daw[i];
         }
 
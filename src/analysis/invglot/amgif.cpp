@@ -88,24 +88,17 @@ void AMGIF::computeC()
             // Calculate circular convolution with FFT.
 
             rpm::vector<std::dcomplex> out(mu1 / 2 + 1);
-            for (int k = 0; k < mu1; ++k) {
-                fft.input(k) = basis[i][k];
-            }
+            fft.fillInput(basis[i].data(), mu1);
             fft.computeForward();
-            for (int k = 0; k < mu1 / 2 + 1; ++k) {
-                out[k] = fft.output(k);
-            }
-            for (int k = 0; k < mu1; ++k) {
-                fft.input(k) = basis[j][k];
-            }
+            fft.copyOutput(out.data(), mu1 / 2 + 1);
+            fft.fillInput(basis[j].data(), mu1);
             fft.computeForward();
+            const auto spectrum = fft.outputView();
             for (int k = 0; k < mu1 / 2 + 1; ++k) {
-                fft.output(k) *= out[k];
+                spectrum[k] *= out[k];
             }
             fft.computeBackward();
-            for (int k = 0; k < mu1; ++k) {
-                conv[k] = fft.input(k);
-            }
+            fft.copyInput(conv.data(), mu1);
 
             // Find the Haar wavelet coefficients of the convolution.
             hwt(conv, +1);
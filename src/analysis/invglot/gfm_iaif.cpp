@@ -1,5 +1,6 @@
 #include "invglot.h"
 #include "../filter/filter.h"
+#include "../window/window.h"
 #include <cmath>
 #include <iostream>
 
@@ -22,17 +23,17 @@ static void applyWindow(const rpm::vector<double>& w, const rpm::vector<double>&
 }
 */
 
-static rpm::vector<double> calculateLPC(const rpm::vector<double>& x, const rpm::vector<double>& w, int len, int order, std::unique_ptr<Analysis::LinpredSolver>& lpc)
+static rpm::vector<double> calculateLPC(const rpm::vector<double>& x, Analysis::BufferView<const double> w, int order, std::unique_ptr<Analysis::LinpredSolver>& lpc)
 {
     static rpm::vector<double> lpcIn;
     static double gain;
 
+    const int len = w.size();
     lpcIn.resize(len);
-    for (int i = 0; i < len; ++i) {
-        lpcIn[i] = w[i] * x[x.size() / 2 - len / 2 + i];
-    }
-    auto a = lpc->solve(lpcIn.data(), len, order, &gain);
-    a.insert(a.begin(), 1.0);
+    Analysis::applyWindow(x.data() + x.size() / 2 - len / 2, w, lpcIn.data());
+    rpm::vector<double> a(order + 1);
+    a[0] = 1.0;
+    a.resize(1 + lpc->solve(lpcIn.data(), len, order, a.data() + 1, &gain));
     return a;
 }
 
@@ -90,13 +91,7 @@ InvglotResult GFM_IAIF::solve(const double *xData, int length, double sampleRate
     rpm::vector<double> one({1.0});
     rpm::vector<double> oneMinusD({1.0, -d});
 
-    static rpm::vector<double> window;
-    if (window.size() != lpW) {
-        window.resize(lpW);
-        for (int i = 0; i < lpW; ++i) {
-            window[i] = 0.5 - 0.5 * cos((2.0 * M_PI * i) / (double) (length - 1));
-        }
-    }
+    const auto window = Analysis::getWindow(Analysis::WindowType::Hann, lpW);
 
     rpm::vector<double> s_gvl(xData, xData + length);
 
@@ -117,28 +112,28 @@ InvglotResult GFM_IAIF::solve(const double *xData, int length, double sampleRate
     auto s_gv = filter(one, oneMinusD, s_gvl);
     auto x_gv = filter(one, oneMinusD, x_gvl);
     
-    auto ag1 = calculateLPC(s_gv, window, lpW, 1, lpc);
+    auto ag1 = calculateLPC(s_gv, window, 1, lpc);
 
     for (int i = 1; i < ng; ++i) {
         auto x_v1x = filter(ag1, x_gv);
         auto s_v1x = removePreRamp(x_v1x, Lpf);
         
-        auto ag1x = calculateLPC(s_v1x, window, lpW, 1, lpc); 
+        auto ag1x = calculateLPC(s_v1x, window, 1, lpc); 
 
         ag1 = conv(ag1, ag1x);
     }
 
     auto x_v1 = filter(ag1, x_gv);
     auto s_v1 = removePreRamp(x_v1, Lpf);
-    auto av1 = calculateLPC(s_v1, window, lpW, nv, lpc);
+    auto av1 = calculateLPC(s_v1, window, nv, lpc);
 
     auto x_g1 = filter(av1, x_gv);
     auto s_g1 = removePreRamp(x_g1, Lpf);
-    auto ag = calculateLPC(s_g1, window, lpW, ng, lpc);
+    auto ag = calculateLPC(s_g1, window, ng, lpc);
 
     auto x_v = filter(ag, x_gv);
     auto s_v = removePreRamp(x_v, Lpf);
-    auto av = calculateLPC(s_v, window, lpW, nv, lpc);
+    auto av = calculateLPC(s_v, window, nv, lpc);
 
     auto g = removePreRamp(filter(av, x_gv), Lpf);
 
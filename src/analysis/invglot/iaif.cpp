@@ -1,5 +1,6 @@
 #include "invglot.h"
 #include "../filter/filter.h"
+#include "../window/window.h"
 #include <cmath>
 #include <iostream>
 
@@ -12,17 +13,17 @@ IAIF::IAIF(double d)
     lpc = std::make_unique<LP::Burg>();
 }
 
-static rpm::vector<double> calculateLPC(const rpm::vector<double>& x, const rpm::vector<double>& w, int len, int order, std::unique_ptr<Analysis::LinpredSolver>& lpc)
+static rpm::vector<double> calculateLPC(const rpm::vector<double>& x, Analysis::BufferView<const double> w, int order, std::unique_ptr<Analysis::LinpredSolver>& lpc)
 {
     static rpm::vector<double> lpcIn;
     static double gain;
 
+    const int len = w.size();
     lpcIn.resize(len);
-    for (int i = 0; i < len; ++i) {
-        lpcIn[i] = w[i] * x[x.size() / 2 - len / 2 + i];
-    }
-    auto a = lpc->solve(lpcIn.data(), len, order, &gain);
-    a.insert(a.begin(), 1.0);
+    Analysis::applyWindow(x.data() + x.size() / 2 - len / 2, w, lpcIn.data());
+    rpm::vector<double> a(order + 1);
+    a[0] = 1.0;
+    a.resize(1 + lpc->solve(lpcIn.data(), len, order, a.data() + 1, &gain));
     return a;
 }
 
@@ -41,13 +42,7 @@ InvglotResult IAIF::solve(const double *xData, int length, double sampleRate)
     rpm::vector<double> one({1.0});
     rpm::vector<double> oneMinusD({1.0, -d});
 
-    static rpm::vector<double> window;
-    if ((int)window.size() != lpW) {
-        window.resize(lpW);
-        for (int i = 0; i < lpW; ++i) {
-            window[i] = 0.5 - 0.5 * cos((2.0 * M_PI * i) / (double) (length - 1));
-        }
-    }
+    const auto window = Analysis::getWindow(Analysis::WindowType::Hann, lpW);
 
     rpm::vector<double> x(xData, xData + length);
    
@@ -69,16 +64,16 @@ InvglotResult IAIF::solve(const double *xData, int length, double sampleRate)
     xWithPreRamp = sosfilter(hpfilt, xWithPreRamp);
     x = removePreRamp(xWithPreRamp, preflt);
 
-    auto Hg1 = calculateLPC(x, window, lpW, 1, lpc);
+    auto Hg1 = calculateLPC(x, window, 1, lpc);
     auto y1 = removePreRamp(filter(Hg1, one, xWithPreRamp), preflt);
 
-    auto Hvt1 = calculateLPC(y1, window, lpW, p_vt, lpc);
+    auto Hvt1 = calculateLPC(y1, window, p_vt, lpc);
     auto g1 = removePreRamp(filter(one, oneMinusD, filter(Hvt1, one, xWithPreRamp)), preflt);
 
-    auto Hg2 = calculateLPC(g1, window, lpW, p_gl, lpc);
+    auto Hg2 = calculateLPC(g1, window, p_gl, lpc);
     auto y = removePreRamp(filter(one, oneMinusD, filter(Hg2, one, xWithPreRamp)), preflt);
 
-    auto Hvt2 = calculateLPC(y, window, lpW, p_vt, lpc);
+    auto Hvt2 = calculateLPC(y, window, p_vt, lpc);
     auto g = removePreRamp(filter(one, oneMinusD, filter(Hvt2, one, xWithPreRamp)), preflt);
 
     double gMax = 1e-10;
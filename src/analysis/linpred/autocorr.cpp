@@ -1,63 +1,147 @@
 #include "linpred.h"
+#include "../simd/simd.h"
+#include <algorithm>
 
+using namespace Analysis;
 using namespace Analysis::LP;
 
-rpm::vector<double> Autocorr::solve(const double *data, int length, int lpcOrder, double *pGain)
+// Levinson-Durbin recursion. Order is the LPC order when it is known at compile time,
+// or 0 to use the runtime order m.
+template<int Order>
+static int levinsonRecursion(const double *r, const int mRuntime, double *a, double *pGain)
 {
-    const int n = length;
-    const int m = lpcOrder;
+    const int m = Order > 0 ? Order : mRuntime;
 
-    r.resize(1 + (m + 1));
-    a.resize(1 + (m + 1));
-    rc.resize(1 + (m));
-    double gain;
-    int i, j;
-    std::fill(r.begin(), r.end(), 0.0);
-    std::fill(a.begin(), a.end(), 0.0);
-    std::fill(rc.begin(), rc.end(), 0.0);
-
-    j = m + 1;
-    while (j--) {
-        double d = 0.0;
-        for (i = j; i < n; ++i)
-            d += data[i] * data[i - j];
-        r[j + 1] = d;
-    }
-    if (r[1] == 0.0) {
-        i = 1;
-        gain = 1e-10;
-        goto end;
+    std::fill(a, a + m + 1, 0.0);
+    a[0] = 1.0;
+
+    if (r[0] == 0.0) {
+        *pGain = 1e-10;
+        return 0;
     }
 
-    a[1] = 1.0;
-    a[2] = rc[1] = -r[2] / r[1];
-    gain = r[1] + r[2] * rc[1];
+    a[1] = -r[1] / r[0];
+    double gain = r[0] + r[1] * a[1];
 
+    int i;
     for (i = 2; i <= m; ++i) {
         double s = 0.0;
-        for (j = 1; j <= i; ++j)
-            s += r[i - j + 2] * a[j];
-        rc[i] = -s / gain;
-        for (j = 2; j <= i / 2 + 1; ++j) {
-            const double at = a[j] + rc[i] * a[i - j + 2];
-            a[i - j + 2] += rc[i] * a[j];
+        for (int j = 0; j < i; ++j)
+            s += r[i - j] * a[j];
+        const double rc = -s / gain;
+        for (int j = 1; j <= i / 2; ++j) {
+            const double at = a[j] + rc * a[i - j];
+            a[i - j] += rc * a[j];
             a[j] = at;
         }
-        a[i + 1] = rc[i];
-        gain += rc[i] * s;
+        a[i] = rc;
+        gain += rc * s;
+        if (gain <= 0.0)
+            break;
+    }
+
+    *pGain = gain;
+    return i - 1;
+}
+
+int Analysis::LP::levinson(const double *r, int lpcOrder, double *a, double *gain)
+{
+    return levinsonRecursion<0>(r, lpcOrder, a, gain);
+}
+
+int Analysis::LP::levinsonAllOrders(const double *r, int maxOrder, double *a, double *gains)
+{
+    const int stride = maxOrder + 1;
+
+    a[0] = 1.0;
+
+    if (r[0] == 0.0) {
+        gains[0] = 1e-10;
+        return 0;
+    }
+
+    gains[0] = r[0];
+
+    for (int i = 1; i <= maxOrder; ++i) {
+        const double *prev = a + (i - 1) * stride;
+        double *cur = a + i * stride;
+
+        double s = 0.0;
+        for (int j = 0; j < i; ++j)
+            s += r[i - j] * prev[j];
+        const double rc = -s / gains[i - 1];
+
+        const double gain = gains[i - 1] + rc * s;
         if (gain <= 0.0)
-            goto end;
+            return i - 1;
+
+        cur[0] = 1.0;
+        for (int j = 1; j < i; ++j)
+            cur[j] = prev[j] + rc * prev[i - j];
+        cur[i] = rc;
+        gains[i] = gain;
     }
 
-end:
-    --i;
+    return maxOrder;
+}
+
+template<int Order>
+std::array<double, Order> Autocorr::solve(const double *x, int length, double *pGain, int *pOrder)
+{
+    std::array<double, Order + 1> r, a;
+    double gain;
+
+    SIMD::autocorrelation(x, length, Order, r.data());
+    const int order = levinsonRecursion<Order>(r.data(), Order, a.data(), &gain);
+
+    std::array<double, Order> lpc;
+    std::fill(lpc.begin(), lpc.end(), 0.0);
+    std::copy(a.begin() + 1, a.begin() + 1 + order, lpc.begin());
+
+    if (pGain != nullptr)
+        *pGain = gain;
+    if (pOrder != nullptr)
+        *pOrder = order;
+    return lpc;
+}
+
+int Autocorr::solve(const double *x, int length, int lpcOrder, double *lpc, double *pGain)
+{
+    int order;
+    double gain;
+
+    const bool fixed = dispatchOrder(lpcOrder, [&](auto fixedOrder) {
+        const auto a = solve<decltype(fixedOrder)::value>(x, length, &gain, &order);
+        std::copy(a.begin(), a.begin() + order, lpc);
+    });
+
+    if (!fixed) {
+        r.resize(lpcOrder + 1);
+        a.resize(lpcOrder + 1);
+        SIMD::autocorrelation(x, length, lpcOrder, r.data());
+        order = levinsonRecursion<0>(r.data(), lpcOrder, a.data(), &gain);
+        std::copy(a.begin() + 1, a.begin() + 1 + order, lpc);
+    }
 
     if (pGain != nullptr)
         *pGain = gain;
-    
-    rpm::vector<double> lpc(i);
-    for (j = 1; j <= i; ++j)
-       lpc[j - 1] = a[j + 1];
+    return order;
+}
+
+int Autocorr::solveAllOrders(const double *x, int length, int maxOrder, double *a, double *gains)
+{
+    r.resize(maxOrder + 1);
+    SIMD::autocorrelation(x, length, maxOrder, r.data());
+    return levinsonAllOrders(r.data(), maxOrder, a, gains);
+}
+
+rpm::vector<double> Autocorr::solve(const double *x, int length, int lpcOrder, double *pGain)
+{
+    rpm::vector<double> lpc(lpcOrder);
+    lpc.resize(solve(x, length, lpcOrder, lpc.data(), pGain));
     return lpc;
 }
 
+#define ANALYSIS_LP_INSTANTIATE(Order) \
+    template std::array<double, Order> Autocorr::solve<Order>(const double *, int, double *, int *);
+ANALYSIS_LP_FIXED_ORDERS(ANALYSIS_LP_INSTANTIATE)
@@ -1,88 +1,159 @@
 #include "linpred.h"
+#include "../simd/simd.h"
 #include <algorithm>
 
+using namespace Analysis;
 using namespace Analysis::LP;
 
-static double vecBurgBuffered(
-        double *lpc,
+// Burg's method. The forward and backward errors f and b are kept in T,
+// the coefficients always in double.
+// f and b need room for n values, aa for m.
+// onOrder(i, a, xms) is called with the (non-negated) solution of each order i as it is reached.
+template<typename T, typename OnOrder>
+static double burg(
+        double *a,
         const int m,
-        const double *data,
+        const double *x,
         const int n,
-        rpm::vector<double>& b1,
-        rpm::vector<double>& b2,
-        rpm::vector<double>& aa)
+        T *f,
+        T *b,
+        double *aa,
+        OnOrder&& onOrder)
 {
-    b1.resize(1 + (n));
-    b2.resize(1 + (n));
-    aa.resize(1 + (m));
-    int i, j;
-    std::fill(b1.begin(), b1.end(), 0.0);
-    std::fill(b2.begin(), b2.end(), 0.0);
-    std::fill(aa.begin(), aa.end(), 0.0);
-
-    // Simulating index-1-based array.
-    double *a = &lpc[-1];
-    const double *x = &data[-1];
-    
-    double p = 0.0;
-    for (j = 1; j <= n; ++j)
-        p += x[j] * x[j];
+    std::fill(aa, aa + m, 0.0);
+
+    const double p = SIMD::dotProduct(x, x, n);
 
     double xms = p / n;
     if (xms <= 0.0) {
         return xms;
     }
 
-    b1[1] = x[1];
-    b2[n - 1] = x[n];
-    for (j = 2; j <= n - 1; ++j)
-        b1[j] = b2[j - 1] = x[j];
+    for (int j = 0; j < n - 1; ++j) {
+        f[j] = static_cast<T>(x[j]);
+        b[j] = static_cast<T>(x[j + 1]);
+    }
+    f[n - 1] = b[n - 1] = 0;
 
-    for (i = 1; i <= m; ++i) {
-        double num = 0.0, denum = 0.0;
-        for (j = 1; j <= n - i; ++j) {
-            num += b1[j] * b2[j];
-            denum += b1[j] * b1[j] + b2[j] * b2[j];
-        }
+    T num = 0, denum = 0;
+    for (int j = 0; j < n - 1; ++j) {
+        num += f[j] * b[j];
+        denum += f[j] * f[j] + b[j] * b[j];
+    }
 
-        if (denum <= 0.0)
+    for (int i = 1; i <= m; ++i) {
+        if (denum <= 0)
             return 0.0;
 
-        a[i] = 2.0 * num / denum;
+        const double k = 2.0 * num / denum;
+        a[i - 1] = k;
+
+        xms *= 1.0 - k * k;
 
-        xms *= 1.0 - a[i] * a[i];
+        for (int j = 0; j < i - 1; ++j)
+            a[j] = aa[j] - k * aa[i - 2 - j];
 
-        for (j = 1; j <= i - 1; ++j)
-            a[j] = aa[j] - a[i] * aa[i - j];
+        onOrder(i, a, xms);
 
         if (i < m) {
-            for (j = 1; j <= i; ++j)
+            for (int j = 0; j < i; ++j)
                 aa[j] = a[j];
-            for (j = 1; j <= n - i - 1; ++j) {
-                b1[j] -= aa[i] * b2[j];
-                b2[j] = b2[j + 1] - aa[i] * b1[j + 1];
-            }
+            // The error update and the next stage's reductions are done in one pass.
+            SIMD::burgStage(f, b, static_cast<T>(k), n - i - 1, &num, &denum);
         }
     }
-   
-    return xms; 
+
+    return xms;
 }
 
-rpm::vector<double> Burg::solve(const double *x, int length, int lpcOrder, double *pGain)
+// Turns the recursion output into LPC coefficients and gain, and returns the order found.
+static int finishBurg(double *lpc, const int m, const int n, double *pGain)
 {
-    const int n = length;
-    const int m = lpcOrder;
-    rpm::vector<double> lpc(m);
-    double gain = vecBurgBuffered(lpc.data(), m, x, n, b1, b2, aa);
+    double& gain = *pGain;
+    int order = m;
     if (gain <= 0.0) {
-        lpc.resize(0);
+        std::fill(lpc, lpc + m, 0.0);
+        order = 0;
         gain = 1e-10;
     }
     gain *= n;
-    for (auto& x : lpc) {
-        x = -x;
+    for (int i = 0; i < order; ++i) {
+        lpc[i] = -lpc[i];
+    }
+    return order;
+}
+
+Burg::Burg(bool singlePrecision)
+    : mSinglePrecision(singlePrecision)
+{
+}
+
+template<typename OnOrder>
+double Burg::recurse(double *a, int m, const double *x, int n, double *aa, OnOrder&& onOrder)
+{
+    if (mSinglePrecision) {
+        f32.resize(n);
+        b32.resize(n);
+        return burg<float>(a, m, x, n, f32.data(), b32.data(), aa, onOrder);
+    }
+    else {
+        f64.resize(n);
+        b64.resize(n);
+        return burg<double>(a, m, x, n, f64.data(), b64.data(), aa, onOrder);
     }
+}
+
+int Burg::solve(const double *x, int length, int lpcOrder, double *lpc, double *pGain)
+{
+    const int n = length;
+    const int m = lpcOrder;
+
+    aa.resize(m);
+    std::fill(lpc, lpc + m, 0.0);
+    double gain = recurse(lpc, m, x, n, aa.data(),
+                          [](int, const double *, double) {});
+    const int order = finishBurg(lpc, m, n, &gain);
+
     if (pGain != nullptr)
         *pGain = gain;
+    return order;
+}
+
+int Burg::solveAllOrders(const double *x, int length, int maxOrder, double *a, double *gains)
+{
+    const int n = length;
+    const int m = maxOrder;
+    const int stride = m + 1;
+
+    // The second half holds the solution being built.
+    aa.resize(2 * m);
+
+    int reached = 0;
+    double *lpc = aa.data() + m;
+
+    recurse(lpc, m, x, n, aa.data(),
+               [&](int i, const double *k, double e) {
+                   double *row = a + i * stride;
+                   row[0] = 1.0;
+                   for (int j = 0; j < i; ++j)
+                       row[j + 1] = -k[j];
+                   gains[i] = e * n;
+                   reached = i;
+               });
+
+    a[0] = 1.0;
+    gains[0] = SIMD::dotProduct(x, x, n);
+
+    if (gains[0] <= 0.0) {
+        gains[0] = 1e-10 * n;
+    }
+
+    return reached;
+}
+
+rpm::vector<double> Burg::solve(const double *x, int length, int lpcOrder, double *pGain)
+{
+    rpm::vector<double> lpc(lpcOrder);
+    lpc.resize(solve(x, length, lpcOrder, lpc.data(), pGain));
     return lpc;
 }
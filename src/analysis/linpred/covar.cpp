@@ -1,102 +1,112 @@
 #include "linpred.h"
+#include <algorithm>
 
 using namespace Analysis::LP;
 
-rpm::vector<double> Covar::solve(const double *data, int length, int lpcOrder, double *pGain)
+// Covariance method via Cholesky-like orthogonalisation.
+// b needs room for m * (m + 1) / 2 values, grc and beta for m, a and cc for m + 1.
+static int covariance(const double *x, const int n, const int m,
+                      double *b, double *grc, double *beta, double *a, double *cc, double *pGain)
 {
-    const int n = length;
-    const int m = lpcOrder;
+    std::fill(b, b + m * (m + 1) / 2, 0.0);
+    std::fill(grc, grc + m, 0.0);
+    std::fill(beta, beta + m, 0.0);
+    std::fill(a, a + m + 1, 0.0);
+    std::fill(cc, cc + m + 1, 0.0);
 
-    static rpm::vector<double> b, grc, beta, a, cc;
-    b.resize(1 + (m * (m + 1) / 2));
-    grc.resize(1 + (m));
-    beta.resize(1 + (m));
-    a.resize(1 + (m + 1));
-    cc.resize(1 + (m + 1));
-    double gain;
-    int i, j, k;
-    std::fill(b.begin(), b.end(), 0.0);
-    std::fill(grc.begin(), grc.end(), 0.0);
-    std::fill(beta.begin(), beta.end(), 0.0);
-    std::fill(a.begin(), a.end(), 0.0);
-    std::fill(cc.begin(), cc.end(), 0.0);
-   
-    // Simulating index-1-based array.
-    const double *x = &data[-1];
-
-    gain = 0.0;
-    for (i = m + 1; i <= n; ++i) {
-        gain += x[i] * x[i];
-        cc[1] += x[i] * x[i - 1];
-        cc[2] += x[i - 1] * x[i - 1];
+    double gain = 0.0;
+    for (int t = m; t < n; ++t) {
+        gain += x[t] * x[t];
+        cc[0] += x[t] * x[t - 1];
+        cc[1] += x[t - 1] * x[t - 1];
     }
     if (gain == 0.0) {
-        i = 1;
-        gain = 1e-10;
-        goto end;
+        *pGain = 1e-10;
+        return 0;
     }
 
-    b[1] = 1.0;
-    beta[1] = cc[2];
-    a[1] = 1.0;
-    a[2] = grc[1] = -cc[1] / cc[2];
-    gain += grc[1] * cc[1];
+    b[0] = 1.0;
+    beta[0] = cc[1];
+    a[0] = 1.0;
+    a[1] = grc[0] = -cc[0] / cc[1];
+    gain += grc[0] * cc[0];
 
+    int i;
     for (i = 2; i <= m; ++i) {
-        double s = 0.0;
-        for (j = 1; j <= i; ++j)
-            cc[i - j + 2] = cc[i - j + 1]
-                            + x[m - i + 1] * x[m - i + j]
-                            - x[n - i + 1] * x[n - i + j];
-        
-        cc[1] = 0.0;
-        for (j = m + 1; j <= n; ++j)
-            cc[1] += x[j - i] * x[j];
-
-        b[i * (i + 1) / 2] = 1.0;
-        for (j = 1; j <= i - 1; ++j) {
+        // Row i - 1 of the triangular basis starts at bi, row j - 1 at bj.
+        double *bi = b + i * (i - 1) / 2;
+
+        for (int j = 1; j <= i; ++j)
+            cc[i - j + 1] = cc[i - j]
+                            + x[m - i] * x[m - i + j - 1]
+                            - x[n - i] * x[n - i + j - 1];
+
+        cc[0] = 0.0;
+        for (int t = m; t < n; ++t)
+            cc[0] += x[t - i] * x[t];
+
+        bi[i - 1] = 1.0;
+        for (int j = 1; j <= i - 1; ++j) {
+            const double *bj = b + j * (j - 1) / 2;
             double gam = 0.0;
-            if (beta[j] < 0.0)
+            if (beta[j - 1] < 0.0)
                 goto end;
-            else if (beta[j] == 0.0)
+            else if (beta[j - 1] == 0.0)
                 continue;
 
-            for (k = 1; k <= j; ++k)
-                gam += cc[k + 1] * b[j * (j - 1) / 2 + k];
+            for (int k = 0; k < j; ++k)
+                gam += cc[k + 1] * bj[k];
 
-            gam /= beta[j];
-            for (k = 1; k <= j; ++k)
-                b[i * (i - 1) / 2 + k] -= gam * b[j * (j - 1) / 2 + k];
+            gam /= beta[j - 1];
+            for (int k = 0; k < j; ++k)
+                bi[k] -= gam * bj[k];
         }
 
-        beta[i] = 0.0;
-        for (j = 1; j <= i; ++j)
-            beta[i] += cc[j + 1] * b[i * (i - 1) / 2 + j];
-        if (beta[i] <= 0.0)
+        beta[i - 1] = 0.0;
+        for (int j = 0; j < i; ++j)
+            beta[i - 1] += cc[j + 1] * bi[j];
+        if (beta[i - 1] <= 0.0)
             goto end;
 
-        for (j = 1; j <= i; ++j)
+        double s = 0.0;
+        for (int j = 0; j < i; ++j)
             s += cc[j] * a[j];
-        grc[i] = -s / beta[i];
+        grc[i - 1] = -s / beta[i - 1];
 
-        for (j = 2; j <= i; ++j)
-            a[j] += grc[i] * b[i * (i - 1) / 2 + j - 1];
-        a[i + 1] = grc[i];
-        s = grc[i] * grc[i] * beta[i];
-        gain -= s;
+        for (int j = 1; j < i; ++j)
+            a[j] += grc[i - 1] * bi[j - 1];
+        a[i] = grc[i - 1];
+        gain -= grc[i - 1] * grc[i - 1] * beta[i - 1];
         if (gain <= 0.0)
             goto end;
     }
 
 end:
-    --i;
+    *pGain = gain;
+    return i - 1;
+}
+
+int Covar::solve(const double *x, int length, int lpcOrder, double *lpc, double *pGain)
+{
+    const int m = lpcOrder;
+    double gain;
+
+    b.resize(m * (m + 1) / 2);
+    grc.resize(m);
+    beta.resize(m);
+    a.resize(m + 1);
+    cc.resize(m + 1);
+    const int order = covariance(x, length, m, b.data(), grc.data(), beta.data(), a.data(), cc.data(), &gain);
+    std::copy(a.begin() + 1, a.begin() + 1 + order, lpc);
 
     if (pGain != nullptr)
         *pGain = gain;
-    
-    rpm::vector<double> lpc(i);
-    for (j = 1; j <= i; ++j)
-       lpc[j - 1] = a[j + 1];
-    return lpc;
+    return order;
 }
 
+rpm::vector<double> Covar::solve(const double *x, int length, int lpcOrder, double *pGain)
+{
+    rpm::vector<double> lpc(lpcOrder);
+    lpc.resize(solve(x, length, lpcOrder, lpc.data(), pGain));
+    return lpc;
+}
@@ -2,35 +2,92 @@
 #define ANALYSIS_LINPRED_H
 
 #include "rpcxx.h"
+#include "../simd/aligned.h"
+#include <array>
+#include <type_traits>
+
+// Orders that have a compile-time specialisation in Autocorr: the order the Formants
+// processor solves for.
+#define ANALYSIS_LP_FIXED_ORDERS(X) \
+    X(10)
 
 namespace Analysis {
-    
+
     class LinpredSolver {
     public:
         virtual ~LinpredSolver() {}
         virtual rpm::vector<double> solve(const double *x, int length, int lpcOrder, double *gain) = 0;
+
+        // Writes the coefficients to lpc (room for lpcOrder values) and returns how many were found.
+        virtual int solve(const double *x, int length, int lpcOrder, double *lpc, double *gain) = 0;
     };
 
     namespace LP {
+        // Calls f(std::integral_constant<int, Order>()) if lpcOrder has a fixed-order specialisation.
+        template<typename F>
+        bool dispatchOrder(int lpcOrder, F&& f)
+        {
+            switch (lpcOrder) {
+#define ANALYSIS_LP_DISPATCH_CASE(Order) \
+            case Order: f(std::integral_constant<int, Order>()); return true;
+            ANALYSIS_LP_FIXED_ORDERS(ANALYSIS_LP_DISPATCH_CASE)
+#undef ANALYSIS_LP_DISPATCH_CASE
+            default:
+                return false;
+            }
+        }
+
+        // Levinson-Durbin recursion on the autocorrelation r[0..lpcOrder]. Writes the AR polynomial
+        // to a (room for lpcOrder + 1 values, a[0] = 1) and returns the order reached.
+        int levinson(const double *r, int lpcOrder, double *a, double *gain);
+
+        // Same recursion, keeping every intermediate order: row p of a (stride maxOrder + 1) receives
+        // the AR polynomial of order p and gains[p] its prediction error. Returns the highest order
+        // reached; rows past it are left untouched.
+        int levinsonAllOrders(const double *r, int maxOrder, double *a, double *gains);
+
         class Autocorr : public LinpredSolver {
         public:
             rpm::vector<double> solve(const double *x, int length, int lpcOrder, double *gain) override;
+            int solve(const double *x, int length, int lpcOrder, double *lpc, double *gain) override;
+
+            // Returns the coefficients zero-padded to Order, with the number actually found in *pOrder.
+            template<int Order>
+            std::array<double, Order> solve(const double *x, int length, double *gain, int *pOrder = nullptr);
+
+            // Every order from 0 to maxOrder in one recursion, laid out as in levinsonAllOrders.
+            int solveAllOrders(const double *x, int length, int maxOrder, double *a, double *gains);
         private:
-            rpm::vector<double> r, a, rc;
+            rpm::vector<double> r, a;
         };
 
         class Covar : public LinpredSolver {
         public:
             rpm::vector<double> solve(const double *x, int length, int lpcOrder, double *gain) override;
+            int solve(const double *x, int length, int lpcOrder, double *lpc, double *gain) override;
         private:
-            rpm::vector<double> r, a, rc;
+            rpm::vector<double> b, grc, beta, a, cc;
         };
 
         class Burg : public LinpredSolver {
         public:
+            // The single precision mode keeps the prediction errors in float, which doubles
+            // the SIMD width of the per-stage update.
+            Burg(bool singlePrecision = false);
+
             rpm::vector<double> solve(const double *x, int length, int lpcOrder, double *gain) override;
+            int solve(const double *x, int length, int lpcOrder, double *lpc, double *gain) override;
+
+            // Every order from 0 to maxOrder in one recursion, laid out as in levinsonAllOrders.
+            int solveAllOrders(const double *x, int length, int maxOrder, double *a, double *gains);
         private:
-            rpm::vector<double> b1, b2, aa;
+            template<typename OnOrder>
+            double recurse(double *a, int m, const double *x, int n, double *aa, OnOrder&& onOrder);
+
+            bool mSinglePrecision;
+            SIMD::AlignedVector<double> f64, b64;
+            SIMD::AlignedVector<float> f32, b32;
+            rpm::vector<double> aa;
         };
     }
 
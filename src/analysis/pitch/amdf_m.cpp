@@ -1,5 +1,6 @@
 #include "pitch.h"
 #include "../util/util.h"
+#include "../simd/simd.h"
 #include <cmath>
 #include <limits>
 
@@ -19,21 +20,19 @@ PitchResult AMDF_M::solve(const double *data, int length, int sampleRate)
 
     const int maxPeriod = std::min<int>(ceil(sampleRate / mMinPitch), maxShift - 1);
     const int minPeriod = std::max<int>(floor(sampleRate / mMaxPitch), 2);
-    
+
+    if (maxPeriod < minPeriod) {
+        return {0.0, false};
+    }
+
     // Calculate the AMDF.
     mAMDF.resize(maxShift);
-    
+
     double Vmax = 0.0;
     double Vmin = std::numeric_limits<double>::max();
 
     for (int i = 0; i < maxShift; ++i) {
-        double sum = 0.0;
-
-        for (int j = 0; j < maxShift - i; ++j) {
-            sum += fabs(data[j] - data[i + j]);
-        }
-
-        mAMDF[i] = sum / (maxShift - i);
+        mAMDF[i] = SIMD::absDiffSum(data, data + i, maxShift - i) / (maxShift - i);
 
         if (mAMDF[i] > Vmax) {
             Vmax = mAMDF[i];
@@ -43,42 +42,30 @@ PitchResult AMDF_M::solve(const double *data, int length, int sampleRate)
         }
     }
 
-    // Convert to 1-bit AMDF.
+    // Convert to 1-bit AMDF, with one extra zero word so that shifted reads stay in bounds.
     const double theta = mAlpha * (Vmax + Vmin);
 
-    m1bAMDF.resize(maxShift / 32 + 1);
+    const int nWords = (maxShift + 63) / 64;
 
-    for (int k = 0; k < maxShift / 32 + 1; ++k) {
-        uint32_t v = 0u;
+    m1bAMDF.assign(nWords + 1, 0u);
 
-        for (int bit = 0; bit < 32; ++bit) {
-            int i = k * 32 + bit;
-            if (i < maxShift && mAMDF[i] <= theta) {
-                v |= 1u << bit;
-            }
+    for (int i = 0; i < maxShift; ++i) {
+        if (mAMDF[i] <= theta) {
+            m1bAMDF[i / 64] |= uint64_t(1) << (i % 64);
         }
-
-        m1bAMDF[k] = v;
     }
 
-    // Calculate the ACF for the 1-bit AMDF signal.
-    m1bACF.resize(maxShift);
-
-    for (int i = 0; i < maxShift; ++i) {
-        int sum = 0;
-
-        for (int j = 0; j < maxShift - i; ++j) {
-            int aInd = j / 32;
-            int aBit = j % 32;
+    // Calculate the ACF for the 1-bit AMDF signal, only at the lags that are searched.
+    // Bits past the end are zero, so whole words can be compared.
+    m1bACF.assign(maxPeriod + 2, 0.0);
 
-            int bInd = (i + j) / 32;
-            int bBit = (i + j) % 32;
+    m1bACF[0] = SIMD::andPopCount(m1bAMDF.data(), m1bAMDF.data(), 0, nWords);
 
-            if ((m1bAMDF[aInd] & (1u << aBit)) && (m1bAMDF[bInd] & (1u << bBit)))
-                sum++;
-        }
+    for (int i = minPeriod; i <= maxPeriod; ++i) {
+        const int q = i / 64;
+        const int r = i % 64;
 
-        m1bACF[i] = sum;
+        m1bACF[i] = SIMD::andPopCount(m1bAMDF.data(), m1bAMDF.data() + q, r, nWords - q);
     }
 
     // Find the global peak.
@@ -87,7 +74,7 @@ PitchResult AMDF_M::solve(const double *data, int length, int sampleRate)
             maxPeriod - minPeriod + 1);
 
     if (maxPositions.empty()) {
-        return {.pitch = 0.0, .voiced = false};
+        return {0.0, false};
     }
 
     const double actualCutoff = mAlpha * m1bACF[0];
@@ -101,10 +88,10 @@ PitchResult AMDF_M::solve(const double *data, int length, int sampleRate)
             pitch = (double) sampleRate / (double) i;
 
             if (pitch >= mMinPitch && pitch <= mMaxPitch)
-                return {.pitch = pitch, .voiced = true};
+                return {pitch, true};
         }
     }
 
-    return pitch > 0.0 ? PitchResult {.pitch = pitch, .voiced = true}
-                       : PitchResult {.pitch = 0.0, .voiced = false};
+    return pitch > 0.0 ? PitchResult {pitch, true}
+                       : PitchResult {0.0, false};
 }
@@ -1,19 +1,307 @@
-#include "../util/util.h"
-#include "../filter/filter.h"
-#include "../resampler/resampler.h"
-#include "../../modules/math/constants.h"
 #include "irapt/irapt.h"
 #include "pitch.h"
+#include "../simd/simd.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
-#include <iostream>
-#include <set>
 
 using namespace Analysis;
 
+Pitch::IRAPT::IRAPT()
+    : mSampleRate(0.0),
+      mLookahead(5),
+      mLagWeight(0.3),
+      mTransitionCost(0.2),
+      mFreqWeight(0.5),
+      mVoicingBias(0.0),
+      mHarmFFT(nullptr),
+      mCorrFFT(nullptr),
+      mRingFrames(0),
+      mFrameCount(0)
+{
+}
+
+int Pitch::IRAPT::getLatency() const
+{
+    return mLookahead;
+}
+
 PitchResult Pitch::IRAPT::solve(const double *data, int length, int sampleRate)
 {
-    irapt1();
+    if (sampleRate != mSampleRate) {
+        mSampleRate = sampleRate;
+        mCfg = initCfg(sampleRate);
+
+        mHarmFFT = std::make_shared<ComplexFFT>(mCfg.harm_FFT_size);
+        mCorrFFT = std::make_shared<RealFFT>(1 << mCfg.corr_param.FFT_order);
+
+        resetTracking();
+    }
+
+    decimate(data, length);
+    analyseHarmonics();
+    computeCandidateFunction();
+    updatePath();
+
+    mFrameCount++;
+
+    double f0 = decidePitch();
+
+    if (f0 != 0.0) {
+        return {f0, true};
+    }
+    else {
+        return {0.0, false};
+    }
+}
+
+void Pitch::IRAPT::decimate(const double *data, const int length)
+{
+    const int ratio = mCfg.src_sub_ratio;
+    const auto& h = mCfg.src_filter;
+    const int nh = (int) h.size();
+    const int hh = nh / 2;
+
+    // The analysis needs one extra sample before the window for the phase difference.
+    const int minLength = mCfg.frame_sub_smp + 1;
+    const int outLength = std::max(length / ratio, minLength);
+    const int pad = (outLength - length / ratio) / 2;
+
+    mSub.assign(outLength, 0.0);
+
+    for (int m = 0; m < length / ratio; ++m) {
+        // The filter is symmetric, so it can be applied as a plain dot product.
+        const int start = m * ratio - hh;
+        const int t0 = std::max(0, -start);
+        const int t1 = std::min(nh, length - start);
+
+        if (t1 > t0) {
+            mSub[pad + m] = SIMD::dotProduct(h.data() + t0, data + start + t0, t1 - t0);
+        }
+    }
 }
 
+void Pitch::IRAPT::analyseHarmonics()
+{
+    const int N = mCfg.harm_FFT_size;
+    const int Lw = mCfg.frame_sub_smp;
+    const auto& w = mCfg.frame_window;
+
+    const int start = (int) mSub.size() / 2 - Lw / 2;
+
+    // Both time instants needed for the instantaneous frequency are real,
+    // so they are transformed together as the real and imaginary parts of one batch.
+    auto& fft = *mHarmFFT;
+
+    const auto z = fft.dataView();
+    for (int m = 0; m < Lw; ++m) {
+        z[m] = std::dcomplex(w[m] * mSub[start + m], w[m] * mSub[start - 1 + m]);
+    }
+    std::fill(z.begin() + Lw, z.end(), 0.0);
+    fft.computeForward();
+
+    auto& corr = *mCorrFFT;
+    const int nc = corr.getInputLength();
+    const int nout = corr.getOutputLength();
+
+    const auto power = corr.outputView();
+    std::fill(power.begin(), power.end(), 0.0);
+
+    const double fs = mCfg.fs_f0;
+    const double halfBand = mCfg.FD / 2.0;
+
+    for (int k : mCfg.f0_freq_line_bins) {
+        const std::dcomplex Zk = z[k];
+        const std::dcomplex Znk = std::conj(z[N - k]);
+
+        const std::dcomplex cur = 0.5 * (Zk + Znk);
+        const std::dcomplex prev = std::dcomplex(0.0, -0.5) * (Zk - Znk);
+
+        const double freq = std::arg(cur * std::conj(prev)) * fs / (2.0 * M_PI);
+        const double lineFreq = (k * fs) / N;
+
+        // Only keep lines that actually hold a component within their band.
+        if (freq <= 0.0 || std::abs(freq - lineFreq) > halfBand) {
+            continue;
+        }
+
+        const double linePower = std::norm(cur);
+
+        const double pos = freq * nc / fs;
+        const int bin = (int) pos;
+        const double frac = pos - bin;
+
+        if (bin + 1 < nout) {
+            power[bin] += (1.0 - frac) * linePower;
+            power[bin + 1] += frac * linePower;
+        }
+    }
+
+    corr.computeBackward();
+}
+
+void Pitch::IRAPT::computeCandidateFunction()
+{
+    const auto& cp = mCfg.corr_param;
+    const auto corr = mCorrFFT->inputView();
+    const auto& h = cp.Interp_filter;
+
+    const int I = cp.Interp_factor;
+    const int H = I * cp.Interp_filter_h_size;
+    const int G = cp.Actual_freqs_num;
+
+    mCandFunction.resize(G);
+    mLocalCost.resize(G + 1);
+
+    const double r0 = corr[0];
+
+    if (r0 <= 1e-12) {
+        std::fill(mCandFunction.begin(), mCandFunction.end(), 0.0);
+    }
+    else {
+        // Band-limited interpolation of the normalised correlation at each candidate lag.
+        for (int i = 0; i < G; ++i) {
+            const int a = cp.Actual_indices[i];
+            const int l0 = (a - H + I - 1) / I;
+            const int l1 = (a + H) / I;
+
+            double sum = 0.0;
+            for (int l = l0; l <= l1; ++l) {
+                sum += corr[l] * cp.Lag_taper[l] * h[a - l * I + H];
+            }
+            mCandFunction[i] = sum / r0;
+        }
+    }
+
+    const double beta = mLagWeight / cp.Right_index_actual;
+
+    double maxC = 0.0;
+    for (int i = 0; i < G; ++i) {
+        const double c = mCandFunction[i];
+        mLocalCost[i] = 1.0 - c * (1.0 - beta * cp.Actual_indices[i]);
+        maxC = std::max(maxC, c);
+    }
+    mLocalCost[G] = mVoicingBias + maxC;
+}
+
+void Pitch::IRAPT::resetTracking()
+{
+    const int G = mCfg.corr_param.Actual_freqs_num;
+
+    mRingFrames = std::max(mLookahead, 0) + 1;
+    mFrameCount = 0;
+
+    mBackPointers.assign(mRingFrames * (G + 1), 0);
+    mPathCost.assign(G + 1, 0.0);
+    mPrevPathCost.assign(G + 1, 0.0);
+    mSweepCost.resize(G);
+    mSweepArg.resize(G);
+}
+
+void Pitch::IRAPT::updatePath()
+{
+    const auto& freqs = mCfg.corr_param.Actual_freqs;
+    const int G = mCfg.corr_param.Actual_freqs_num;
+    const int U = G;
+
+    const int slot = mFrameCount % mRingFrames;
+    int *back = &mBackPointers[slot * (G + 1)];
+
+    std::swap(mPathCost, mPrevPathCost);
+
+    if (mFrameCount == 0) {
+        for (int j = 0; j <= G; ++j) {
+            mPathCost[j] = mLocalCost[j];
+            back[j] = j;
+        }
+        return;
+    }
+
+    const auto& P = mPrevPathCost;
+
+    // The voiced-to-voiced cost is linear in |log F0 change|, so the minimum
+    // over all predecessors is a 1-D distance transform done in two sweeps.
+    mSweepCost[0] = P[0];
+    mSweepArg[0] = 0;
+    for (int i = 1; i < G; ++i) {
+        const double carried = mSweepCost[i - 1] + mFreqWeight * log(freqs[i] / freqs[i - 1]);
+        if (carried < P[i]) {
+            mSweepCost[i] = carried;
+            mSweepArg[i] = mSweepArg[i - 1];
+        }
+        else {
+            mSweepCost[i] = P[i];
+            mSweepArg[i] = i;
+        }
+    }
+    for (int i = G - 2; i >= 0; --i) {
+        const double carried = mSweepCost[i + 1] + mFreqWeight * log(freqs[i + 1] / freqs[i]);
+        if (carried < mSweepCost[i]) {
+            mSweepCost[i] = carried;
+            mSweepArg[i] = mSweepArg[i + 1];
+        }
+    }
+
+    int bestVoiced = 0;
+    for (int i = 1; i < G; ++i) {
+        if (P[i] < P[bestVoiced]) {
+            bestVoiced = i;
+        }
+    }
+
+    const double fromUnvoiced = P[U] + mTransitionCost;
+
+    double minCost = HUGE_VAL;
+
+    for (int i = 0; i < G; ++i) {
+        if (fromUnvoiced < mSweepCost[i]) {
+            mPathCost[i] = mLocalCost[i] + fromUnvoiced;
+            back[i] = U;
+        }
+        else {
+            mPathCost[i] = mLocalCost[i] + mSweepCost[i];
+            back[i] = mSweepArg[i];
+        }
+        minCost = std::min(minCost, mPathCost[i]);
+    }
+
+    const double fromVoiced = P[bestVoiced] + mTransitionCost;
+
+    if (fromVoiced < P[U]) {
+        mPathCost[U] = mLocalCost[U] + fromVoiced;
+        back[U] = bestVoiced;
+    }
+    else {
+        mPathCost[U] = mLocalCost[U] + P[U];
+        back[U] = U;
+    }
+    minCost = std::min(minCost, mPathCost[U]);
+
+    // Keep the accumulated costs bounded on long streams.
+    for (int j = 0; j <= G; ++j) {
+        mPathCost[j] -= minCost;
+    }
+}
+
+double Pitch::IRAPT::decidePitch()
+{
+    const int G = mCfg.corr_param.Actual_freqs_num;
+    const int delay = mRingFrames - 1;
+
+    if (mFrameCount <= delay) {
+        return 0.0;
+    }
+
+    int slot = (mFrameCount - 1) % mRingFrames;
+
+    int j = (int) std::distance(mPathCost.begin(),
+                std::min_element(mPathCost.begin(), mPathCost.end()));
+
+    // Trace the best partial path back to the frame being decided.
+    for (int i = 0; i < delay; ++i) {
+        j = mBackPointers[slot * (G + 1) + j];
+        slot = (slot + mRingFrames - 1) % mRingFrames;
+    }
+
+    return j < G ? mCfg.corr_param.Actual_freqs[j] : 0.0;
+}
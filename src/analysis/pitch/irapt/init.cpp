@@ -1,10 +1,19 @@
 #include "irapt.h"
 #include <algorithm>
+#include <numeric>
 #include <cmath>
 
 using namespace Analysis;
 
-static rpm::vector<double> fir1();
+static rpm::vector<double> fir1(int order, double cutoff);
+
+static inline int pow2roundup(int x)
+{
+    int y = 1;
+    while (y < x)
+        y <<= 1;
+    return y;
+}
 
 IRAPT_Cfg Analysis::initCfg(double sampleRate)
 {
@@ -12,12 +21,19 @@ IRAPT_Cfg Analysis::initCfg(double sampleRate)
 
     cfg.fs = sampleRate;
     cfg.fs_f0_target = 6000;
-    cfg.src_sub_ratio = std::round(cfg.fs / cfg.fs_f0_target);
+    cfg.src_sub_ratio = std::max<int>(std::round(cfg.fs / cfg.fs_f0_target), 1);
     cfg.fs_f0 = cfg.fs / cfg.src_sub_ratio;
     cfg.FD = 35;
     cfg.max_harmonic_freq = 14000;
     cfg.max_harmonic_number = 100;
 
+    if (cfg.src_sub_ratio > 1) {
+        cfg.src_filter = fir1(16 * cfg.src_sub_ratio, 1.0 / cfg.src_sub_ratio);
+    }
+    else {
+        cfg.src_filter = { 1.0 };
+    }
+
     cfg.step_sec = 0.02;
     cfg.step_sub_smp = std::round(cfg.step_sec * cfg.fs_f0);
     cfg.step_smp = cfg.step_sub_smp * cfg.src_sub_ratio;
@@ -26,6 +42,11 @@ IRAPT_Cfg Analysis::initCfg(double sampleRate)
     cfg.frame_sub_smp = std::round(cfg.frame_sec * cfg.fs_f0 / 2) * 2 + 1;
     cfg.frame_smp = std::round(cfg.frame_sec * cfg.fs / 2) * 2 + 1;
 
+    cfg.frame_window.resize(cfg.frame_sub_smp);
+    for (int i = 0; i < cfg.frame_sub_smp; ++i) {
+        cfg.frame_window[i] = 0.5 - 0.5 * cos((2.0 * M_PI * (i + 1)) / (cfg.frame_sub_smp + 1));
+    }
+
     cfg.chunk_f0_sec = 0.3;
     cfg.chunk_f0_size = std::round(cfg.chunk_f0_sec / cfg.step_sec);
 
@@ -35,11 +56,94 @@ IRAPT_Cfg Analysis::initCfg(double sampleRate)
 
     cfg.f0_max_step = 23;
 
-    double F = cfg.FD + cfg.FD / 4;
+    double F = cfg.FD + cfg.FD / 4.0;
     while (F <= cfg.fs_f0 / 2 - cfg.FD) {
         cfg.f0_freq_lines.push_back(F);
-        F += cfg.FD / 2;
+        F += cfg.FD / 2.0;
+    }
+
+    // Frequency lines are read off one zero-padded transform, so its bins
+    // have to be at least as dense as the lines.
+    cfg.harm_FFT_size = pow2roundup(std::max<int>(cfg.frame_sub_smp + 1, std::ceil(cfg.fs_f0 / (cfg.FD / 2.0))));
+
+    for (double line : cfg.f0_freq_lines) {
+        const int bin = std::round(line * cfg.harm_FFT_size / cfg.fs_f0);
+        if (cfg.f0_freq_line_bins.empty() || cfg.f0_freq_line_bins.back() != bin) {
+            cfg.f0_freq_line_bins.push_back(bin);
+        }
+    }
+
+    auto& cp = cfg.corr_param;
+
+    cp.Interp_factor = 16;
+    cp.Interp_filter_h_size = 8;
+
+    const int H = cp.Interp_factor * cp.Interp_filter_h_size;
+    cp.Interp_filter = fir1(2 * H, 1.0 / cp.Interp_factor);
+    for (double& h : cp.Interp_filter) {
+        h *= cp.Interp_factor;
+    }
+
+    const double fsInterp = cfg.fs_f0 * cp.Interp_factor;
+
+    cp.Left_index_actual = std::floor(fsInterp / cfg.f0_limits.second);
+    cp.Right_index_actual = std::ceil(fsInterp / cfg.f0_limits.first);
+    cp.Left_index = std::max(cp.Left_index_actual / cp.Interp_factor - cp.Interp_filter_h_size - 1, 0);
+    cp.Right_index = cp.Right_index_actual / cp.Interp_factor + cp.Interp_filter_h_size + 1;
+
+    int fftSize = pow2roundup(4 * (cp.Right_index + 1));
+    cp.FFT_order = 0;
+    while ((1 << cp.FFT_order) < fftSize) {
+        cp.FFT_order++;
+    }
+    cp.FFT_freq_line_size = fftSize / 2 + 1;
+
+    // Candidate frequencies in ascending order, one per distinct interpolated lag.
+    cp.Actual_indices.clear();
+    for (double f0 : cfg.chunk_f0_freqs) {
+        const int index = std::round(fsInterp / f0);
+        if (cp.Actual_indices.empty() || cp.Actual_indices.back() != index) {
+            cp.Actual_indices.push_back(index);
+        }
+    }
+    cp.Actual_freqs_num = (int) cp.Actual_indices.size();
+    cp.Actual_freqs.resize(cp.Actual_freqs_num);
+    for (int i = 0; i < cp.Actual_freqs_num; ++i) {
+        cp.Actual_freqs[i] = fsInterp / cp.Actual_indices[i];
+    }
+
+    // Spreading each harmonic over two adjacent bins tapers the correlation
+    // by sinc^2, which is undone here.
+    cp.Lag_taper.resize(cp.Right_index + 1);
+    cp.Lag_taper[0] = 1.0;
+    for (int l = 1; l <= cp.Right_index; ++l) {
+        const double x = M_PI * l / fftSize;
+        const double sinc = sin(x) / x;
+        cp.Lag_taper[l] = 1.0 / (sinc * sinc);
+    }
+
+    return cfg;
+}
+
+rpm::vector<double> fir1(const int order, const double cutoff)
+{
+    // Hamming-windowed sinc, normalised to unit gain at DC.
+    rpm::vector<double> h(order + 1);
+
+    const double mid = order / 2.0;
+    double sum = 0.0;
+
+    for (int i = 0; i <= order; ++i) {
+        const double x = i - mid;
+        const double sinc = (x == 0.0) ? cutoff : sin(M_PI * cutoff * x) / (M_PI * x);
+        const double w = 0.54 - 0.46 * cos(2.0 * M_PI * i / order);
+        h[i] = sinc * w;
+        sum += h[i];
+    }
+
+    for (double& v : h) {
+        v /= sum;
     }
 
-    cfg.corr_param
+    return h;
 }
@@ -14,6 +14,8 @@ namespace Analysis {
         double max_harmonic_freq;
         int max_harmonic_number;
 
+        rpm::vector<double> src_filter;
+
         double step_sec;
         int step_sub_smp;
         int step_smp;
@@ -21,6 +23,7 @@ namespace Analysis {
         double frame_sec;
         int frame_sub_smp;
         int frame_smp;
+        rpm::vector<double> frame_window;
 
         double chunk_f0_sec;
         int chunk_f0_size;
@@ -30,6 +33,9 @@ namespace Analysis {
         double f0_max_step;
         rpm::vector<double> f0_freq_lines;
 
+        int harm_FFT_size;
+        rpm::vector<int> f0_freq_line_bins;
+
         struct {
             int FFT_order;
             int FFT_freq_line_size;
@@ -43,6 +49,7 @@ namespace Analysis {
             rpm::vector<int> Actual_indices;
             rpm::vector<double> Actual_freqs;
             int Actual_freqs_num;
+            rpm::vector<double> Lag_taper;
         } corr_param;
     };
 
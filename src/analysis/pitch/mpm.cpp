@@ -15,14 +15,15 @@
 #define PMPM_CUTOFF_STEP 0.01
 
 template <typename T>
-static rpm::vector<int>
-peak_picking(const rpm::vector<T> &nsdf)
+static void
+peak_picking(const rpm::vector<T> &nsdf, rpm::vector<int> &max_positions)
 {
-	rpm::vector<int> max_positions{};
 	int pos = 0;
 	int cur_max_pos = 0;
 	int size = (int) nsdf.size();
 
+	max_positions.clear();
+
 	while (pos < (size - 1) / 3 && nsdf[pos] > 0)
 		pos++;
 	while (pos < size - 1 && nsdf[pos] <= 0.0)
@@ -50,7 +51,6 @@ peak_picking(const rpm::vector<T> &nsdf)
 	if (cur_max_pos > 0) {
 		max_positions.push_back(cur_max_pos);
 	}
-	return max_positions;
 }
 
 inline int
@@ -67,41 +67,30 @@ pow2roundup (int x)
     return x+1;
 }
 
-template <typename T>
+Analysis::Pitch::MPM::MPM()
+{
+}
+
 void
-acorr_r(rpm::vector<T> &audio_buffer)
+Analysis::Pitch::MPM::autocorrelation(const double *data, int N, int sampleRate)
 {
-	if (audio_buffer.size() == 0)
+	if (N == 0)
 		throw std::invalid_argument("audio_buffer shouldn't be empty");
 
-        const int N = (int) audio_buffer.size();
-
-        int nfft = 2 * N - 1;
- 
-        static std::shared_ptr<Analysis::RealFFT> fft(nullptr);
+        // Zero-padding to at least 2N-1 avoids circular aliasing, and a
+        // power of two keeps FFTW on its fast radix-2 codelets.
+        const int nfft = pow2roundup(2 * N - 1);
 
-        if (!fft || fft->getInputLength() != nfft) {
-            fft.reset(new Analysis::RealFFT(nfft));
+        if ((int) mNSDF.size() != N) {
+            mNSDF.resize(N);
+            mMaxPositions.reserve(N / 2 + 1);
+            mEstimates.reserve(N / 2 + 1);
         }
 
-        for (int i = 0; i < N; ++i) {
-            fft->input(i) = audio_buffer[i];
-        }
-        for (int i = N; i < nfft; ++i) {
-            fft->input(i) = 0.0;
-        }
-
-        fft->computeForward();
-        
-        for (int i = 0; i < nfft / 2 + 1; ++i) {
-            std::dcomplex z = fft->output(i);
-            fft->output(i) = (z * conj(z)) / (double) nfft;
-        }
-        fft->computeBackward();
+        auto& frame = spectralFrames().get(sampleRate, nfft, Analysis::SpectralWindow::Rectangular, data, N);
+        const auto& acf = frame.autocorrelation();
 
-        for (int i = 0; i < N; ++i) {
-            audio_buffer[i] = fft->input(i);
-        }
+        std::copy(acf.begin(), acf.begin() + N, mNSDF.begin());
 }
 
 Analysis::PitchResult
@@ -109,42 +98,40 @@ Analysis::Pitch::MPM::solve(const double *data, int length, int sample_rate)
 {
     using T = double;
 
-    rpm::vector<T> audio_buffer(data, data + length);
-
-	acorr_r(audio_buffer);
+	autocorrelation(data, length, sample_rate);
 
         double max = 0.02;
         for (int i = 0; i < length; ++i) {
-            if (fabs(audio_buffer[i]) > max) {
-                max = fabs(audio_buffer[i]);
+            if (fabs(mNSDF[i]) > max) {
+                max = fabs(mNSDF[i]);
             }
         }
 
         for (int i = 0; i < length; ++i) {
-            audio_buffer[i] /= max;
+            mNSDF[i] /= max;
         }
 
-	rpm::vector<int> max_positions = peak_picking(audio_buffer);
-	rpm::vector<std::pair<T, T>> estimates;
+	peak_picking(mNSDF, mMaxPositions);
+	mEstimates.clear();
 
 	T highest_amplitude = -DBL_MAX;
 
-	for (int i : max_positions) {
-		highest_amplitude = std::max(highest_amplitude,audio_buffer[i]);
-		if (audio_buffer[i] > MPM_SMALL_CUTOFF) {
-			auto x = parabolicInterpolation(audio_buffer, i);
-			estimates.push_back(x);
+	for (int i : mMaxPositions) {
+		highest_amplitude = std::max(highest_amplitude, mNSDF[i]);
+		if (mNSDF[i] > MPM_SMALL_CUTOFF) {
+			auto x = parabolicInterpolation(mNSDF, i);
+			mEstimates.push_back(x);
 			highest_amplitude = std::max(highest_amplitude, std::get<1>(x));
 		}
 	}
 
-	if (estimates.empty())
+	if (mEstimates.empty())
 		return { 0.0, false };
 
 	T actual_cutoff = MPM_CUTOFF * highest_amplitude;
 	T period = 0;
 
-	for (auto i : estimates) {
+	for (auto i : mEstimates) {
 		if (std::get<1>(i) >= actual_cutoff) {
 			period = std::get<0>(i);
 			break;
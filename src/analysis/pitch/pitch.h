@@ -7,6 +7,7 @@
 
 #include "../fft/fft.h"
 #include "rapt.h"
+#include "irapt/irapt.h"
 
 namespace Analysis {
 
@@ -19,10 +20,30 @@ namespace Analysis {
     public:
         virtual ~PitchSolver() {}
         virtual PitchResult solve(const double *data, int length, int sampleRate) = 0;
+
+        // Number of calls by which results lag behind the input frames.
+        virtual int getLatency() const { return 0; }
+
+        // Transforms shared with the other consumers of the pipeline. Solvers keep their own otherwise.
+        void setSpectralFrames(SpectralFrames *frames) { mSharedFrames = frames; }
+
+    protected:
+        // Without a pipeline to mark the hops, every call starts one.
+        SpectralFrames& spectralFrames()
+        {
+            if (mSharedFrames != nullptr) {
+                return *mSharedFrames;
+            }
+            mOwnFrames.nextHop();
+            return mOwnFrames;
+        }
+
+    private:
+        SpectralFrames *mSharedFrames = nullptr;
+        SpectralFrames mOwnFrames;
     };
 
     namespace Pitch {
-        /*
         class AMDF_M : public PitchSolver {
         public:
             AMDF_M(double minPitch, double maxPitch, double alpha);
@@ -32,10 +53,9 @@ namespace Analysis {
             double mMaxPitch;
             double mAlpha;
             rpm::vector<double> mAMDF;
-            rpm::vector<uint32_t> m1bAMDF;
+            rpm::vector<uint64_t> m1bAMDF;
             rpm::vector<double> m1bACF;
         };
-        */
 
         class Yin : public PitchSolver {
         public:
@@ -43,32 +63,65 @@ namespace Analysis {
             PitchResult solve(const double *data, int length, int sampleRate) override;
         private:
             double mThreshold;
-            std::shared_ptr<ComplexFFT> mFFT;
-            rpm::vector<double> mAutocorrelation;
-            rpm::vector<double> mDifference;
             rpm::vector<double> mCMND;
         };
 
         class MPM : public PitchSolver {
         public:
+            MPM();
             PitchResult solve(const double *data, int length, int sampleRate) override;
+        private:
+            void autocorrelation(const double *data, int length, int sampleRate);
+
+            rpm::vector<double> mNSDF;
+            rpm::vector<int> mMaxPositions;
+            rpm::vector<std::pair<double, double>> mEstimates;
         };
 
         class RAPT : public PitchSolver, public Analysis::RAPT {
         public:
             RAPT();
             PitchResult solve(const double *data, int length, int sampleRate) override;
-        private:
-            rpm::vector<double> pitches;
+            int getLatency() const override;
         };
 
-        /*
         class IRAPT : public PitchSolver {
         public:
             IRAPT();
             PitchResult solve(const double *data, int length, int sampleRate) override;
+            int getLatency() const override;
+        private:
+            void decimate(const double *data, int length);
+            void analyseHarmonics();
+            void computeCandidateFunction();
+            void updatePath();
+            double decidePitch();
+            void resetTracking();
+
+            double mSampleRate;
+            IRAPT_Cfg mCfg;
+
+            int mLookahead;
+            double mLagWeight;
+            double mTransitionCost;
+            double mFreqWeight;
+            double mVoicingBias;
+
+            std::shared_ptr<ComplexFFT> mHarmFFT;
+            std::shared_ptr<RealFFT> mCorrFFT;
+            rpm::vector<double> mSub;
+            rpm::vector<double> mCandFunction;
+            rpm::vector<double> mLocalCost;
+
+            // Online Viterbi state over the candidate grid, plus one unvoiced state.
+            int mRingFrames;
+            int64_t mFrameCount;
+            rpm::vector<int> mBackPointers;
+            rpm::vector<double> mPathCost;
+            rpm::vector<double> mPrevPathCost;
+            rpm::vector<double> mSweepCost;
+            rpm::vector<int> mSweepArg;
         };
-        */
     }
 
 }
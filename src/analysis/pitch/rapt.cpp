@@ -2,7 +2,7 @@
 #include "../filter/filter.h"
 #include "rapt.h"
 #include "pitch.h"
-#include <samplerate.h>
+#include "../simd/simd.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -25,7 +25,12 @@ Pitch::RAPT::RAPT()
     a_fact  = 10000;
     n_cands = 20;
 
-    nbFrames = 1;
+    lookahead = 5;
+}
+
+int Pitch::RAPT::getLatency() const
+{
+    return std::max(lookahead, 0);
 }
 
 PitchResult Pitch::RAPT::solve(const double *data, int length, int sampleRate)
@@ -42,30 +47,43 @@ PitchResult Pitch::RAPT::solve(const double *data, int length, int sampleRate)
 
 static void subtractReferenceMean(rpm::vector<double>& s, int n, int K);
 
-static rpm::vector<double> downsampleSignal(const rpm::vector<double>& s, const double Fs, const double Fds);
-
-static rpm::vector<double> calculateDownsampledNCCF(const rpm::vector<double>& dss, const int dsn, const int dsK1, const int dsK2);
+static void findPeaksWithThreshold(const rpm::vector<double>& nccf, const double cand_tr, const int n_cands, const bool paraInterp, PeakFinder& finder, rpm::vector<std::pair<double, double>>& peaks);
 
-static rpm::vector<std::pair<double, double>> findPeaksWithThreshold(const rpm::vector<double>& nccf, const double cand_tr, const int n_cands, const bool paraInterp);
-
-static rpm::vector<double> calculateOriginalNCCF(const rpm::vector<double>& s, const double Fs, const double Fds, const int n, const int K, const rpm::vector<std::pair<double, double>>& dsPeaks);
-
-static rpm::vector<RAPT::Cand> createCosts(const rpm::vector<std::pair<double, double>>& peaks, const double vo_bias, const double beta);
+static void createCosts(const rpm::vector<std::pair<double, double>>& peaks, const double vo_bias, const double beta, rpm::vector<RAPT::Cand>& costs);
 
 static double calculateRMS(const rpm::vector<double>& s, const int start, const int length);
 
-static double expDistItakura(const rpm::vector<double>& ar1, const rpm::vector<double>& ar2);
+static void lpcar2ra(const double *ar, int p, double *ra);
+static void lpcar2rr(const double *ar, int p, double *rr, double *rf, double *temp, double *a);
+static void lpcar2rf(const double *ar, int p, double *rf, double *temp);
+static void lpcrf2rr(const double *rf, int p, double *rr, double *a);
 
-static rpm::vector<double> lpcar2ra(const rpm::vector<double>& ar);
-static rpm::vector<double> lpcar2rr(const rpm::vector<double>& ar);
-static rpm::vector<double> lpcar2rf(const rpm::vector<double>& ar);
-static rpm::vector<double> lpcrf2rr(const rpm::vector<double>& rf);
+static inline int pow2roundup(int x)
+{
+    int y = 1;
+    while (y < x)
+        y <<= 1;
+    return y;
+}
 
 RAPT::RAPT()
-    : lpcOrder(-1)
+    : lpcOrder(-1),
+      lookahead(5),
+      ringFrames(0),
+      ringCands(0),
+      frameCount(0),
+      xcorrFFT(nullptr),
+      src(nullptr)
 {
 }
 
+RAPT::~RAPT()
+{
+    if (src != nullptr) {
+        src_delete(src);
+    }
+}
+
 double RAPT::computeFrame(const double *data, int length, double Fs)
 {
     if (lpcOrder < 0) {
@@ -84,9 +102,9 @@ double RAPT::computeFrame(const double *data, int length, double Fs)
 
     const double beta = lag_wt / (Fs / F0min);
     
-    const int J = std::round(0.03 * Fs);
+    const int J = std::min<int>(std::round(0.03 * Fs), length);
 
-    rpm::vector<double> s(data, data + length);
+    s.assign(data, data + length);
     
     if ((int) s.size() < n + K) {
         s.resize(n + K, 0.0);
@@ -94,161 +112,186 @@ double RAPT::computeFrame(const double *data, int length, double Fs)
 
     subtractReferenceMean(s, n, K);
 
-    auto dss = downsampleSignal(s, Fs, Fds);
+    downsampleSignal(Fs, Fds);
     
     if ((int) dss.size() < dsn + dsK2) {
         dss.resize(dsn + dsK2, 0.0);
     }
     
-    auto dsNCCF = calculateDownsampledNCCF(dss, dsn, dsK1, dsK2);
-    auto dsPeaks = findPeaksWithThreshold(dsNCCF, cand_tr, n_cands, true);
+    calculateDownsampledNCCF(dsn, dsK1, dsK2);
+    findPeaksWithThreshold(dsNCCF, cand_tr, n_cands, true, peakFinder, dsPeaks);
    
-    rpm::vector<std::pair<double, double>> peaks;
+    peaks.clear();
    
-    rpm::vector<double> nccf;
     if (dsPeaks.size() > 0) {
-        nccf = calculateOriginalNCCF(s, Fs, Fds, n, K, dsPeaks);
-        peaks = findPeaksWithThreshold(nccf, cand_tr, n_cands, false);
-    }
-
-    if ((int) frames.size() != nbFrames) {
-        Frame defaultFrame = {
-            { { vo_bias, false } },
-            1e-10,
-            1.0,
-            1.0,
-            {},
-            -0.25,
-        };
-        frames.resize(nbFrames, defaultFrame);
+        calculateOriginalNCCF(Fs, Fds, n, K);
+        findPeaksWithThreshold(nccf, cand_tr, n_cands, false, peakFinder, peaks);
     }
 
-    Frame frm;
-    frm.Fs = Fs;
-    frm.cands = createCosts(peaks, vo_bias, beta);
-  
-    if (nbFrames > 1) {
-        frm.rms = calculateRMS(s, length / 2 - J / 2, J);
-        frm.rr = frm.rms / frames.back().rms;
-    
-        // Pre-emphasis.
-        const double alpha = expf(-7000 / Fs);
-        for (int i = (int) s.size() - 1; i >= 1; --i) {
-            s[i] -= alpha * s[i - 1];
-        }
+    if (ringFrames != std::max(lookahead, 0) + 1 || ringCands != n_cands) {
+        resetTracking();
+    }
+
+    createCosts(peaks, vo_bias, beta, cands);
+
+    // Voicing transition modifiers relative to the previous frame.
+    const double rms = calculateRMS(s, length / 2 - J / 2, J);
+    double rr = 1.0;
+    double S = -0.25;
 
-        // Calculate AR.
-        double gain;
-        frm.ar = lpc.solve(s.data(), (int) s.size(), lpcOrder, &gain);
-        frm.ar.insert(frm.ar.begin(), 1.0);
-        frm.S = 0.2 / (expDistItakura(frm.ar, frames.back().ar) - 0.8);
+    // Pre-emphasis.
+    const double alpha = expf(-7000 / Fs);
+    for (int i = (int) s.size() - 1; i >= 1; --i) {
+        s[i] -= alpha * s[i - 1];
     }
 
-    double pitch = 0.0;
-    
-    if (frm.cands[0].voiced) {
-        double Linterp = std::get<0>(parabolicInterpolation(nccf, frm.cands[0].L));
-        pitch = frm.Fs / Linterp;
+    // Calculate AR.
+    double gain;
+    ar.resize(lpcOrder + 1);
+    ar[0] = 1.0;
+    ar.resize(1 + lpc.solve(s.data(), (int) s.size(), lpcOrder, ar.data() + 1, &gain));
+
+    if (frameCount > 0) {
+        rr = rms / prevRms;
+        S = 0.2 / (expDistItakura(ar, prevAr) - 0.8);
     }
 
-    frames.pop_front();
-    frames.push_back(std::move(frm));
+    prevRms = rms;
+    std::swap(prevAr, ar);
+
+    // Store the candidates with their refined pitch, since the NCCF
+    // is gone by the time the frame gets decided.
+    const int slot = frameCount % ringFrames;
+    const int nc = (int) cands.size();
+
+    ringCounts[slot] = nc;
+
+    for (int j = 0; j < nc; ++j) {
+        ringCandidates[slot * ringCands + j] = cands[j];
+
+        if (cands[j].voiced) {
+            double Linterp = std::get<0>(parabolicInterpolation(nccf, cands[j].L));
+            ringPitches[slot * ringCands + j] = Fs / Linterp;
+        }
+        else {
+            ringPitches[slot * ringCands + j] = 0.0;
+        }
+    }
 
-    return pitch;
+    updatePath(rr, S);
+
+    frameCount++;
+
+    return decidePitch();
 }
 
-rpm::vector<double> RAPT::computePath()
+void RAPT::resetTracking()
 {
-    static rpm::vector<rpm::vector<rpm::vector<double>>> transitionMatrices;
+    ringFrames = std::max(lookahead, 0) + 1;
+    ringCands = n_cands;
+    frameCount = 0;
+
+    ringCandidates.resize(ringFrames * ringCands);
+    ringPitches.resize(ringFrames * ringCands);
+    ringCounts.assign(ringFrames, 0);
+    ringBackPointers.assign(ringFrames * ringCands, 0);
+    pathCost.assign(ringCands, 0.0);
+    prevPathCost.assign(ringCands, 0.0);
+    cands.reserve(ringCands);
+
+    prevRms = 1e-10;
+}
 
-    transitionMatrices.resize(nbFrames);
+void RAPT::updatePath(const double rr, const double S)
+{
+    const int slot = frameCount % ringFrames;
+    const int prevSlot = (frameCount + ringFrames - 1) % ringFrames;
 
-    for (int i = 1; i < nbFrames; ++i) {
-        const int nj = (int) frames[i].cands.size();
-        const int nk = (int) frames[i - 1].cands.size();
+    const int nj = ringCounts[slot];
+    const int nk = frameCount > 0 ? ringCounts[prevSlot] : 0;
 
-        auto& mat = transitionMatrices[i];
-        mat.resize(nj);
+    const Cand *cur = &ringCandidates[slot * ringCands];
+    const Cand *prev = &ringCandidates[prevSlot * ringCands];
+    int *back = &ringBackPointers[slot * ringCands];
 
-        const double rri = frames[i].rr;
-        const double Si = frames[i].S;
-        
-        for (int j = 0; j < nj; ++j) {
-            auto& row = mat[j];
-            row.resize(nk);
-            
-            const auto& cj = frames[i].cands[j];
+    std::swap(pathCost, prevPathCost);
+
+    double minCost = HUGE_VAL;
+
+    for (int j = 0; j < nj; ++j) {
+        const auto& cj = cur[j];
+
+        double min = 0.0;
+        int kmin = 0;
+
+        if (nk > 0) {
+            min = HUGE_VAL;
 
             for (int k = 0; k < nk; ++k) {
+                const auto& ck = prev[k];
 
-                const auto& ck = frames[i - 1].cands[k];
+                double trans;
 
                 if (cj.voiced && ck.voiced) { // Voiced to voiced
-                    double xi = fabsf(logf(cj.L / ck.L));
-                    row[k] = freq_wt * std::min((double) xi, (doubl_c + fabs(xi - M_LN2)));
+                    double xi = fabs(log(cj.L / ck.L));
+                    trans = freq_wt * std::min(xi, doubl_c + fabs(xi - M_LN2));
                 }
                 else if (!cj.voiced && ck.voiced) { // Voiced to unvoiced
-                    row[k] = vtran_c + vtr_s_c * Si + vtr_a_c * rri;
+                    trans = vtran_c + vtr_s_c * S + vtr_a_c * rr;
                 }
                 else if (cj.voiced && !ck.voiced) { // Unvoiced to voiced
-                    row[k] = vtran_c + vtr_s_c * Si + vtr_a_c / rri;
+                    trans = vtran_c + vtr_s_c * S + vtr_a_c / rr;
                 }
                 else { // Unvoiced to unvoiced
-                    row[k] = 0.0;
+                    trans = 0.0;
                 }
-            }
-        }
-    }
-
-    static rpm::vector<rpm::vector<double>> D;
-    static rpm::vector<rpm::vector<int>> ks;
-    
-    D.resize(nbFrames + 1);
-    D[0].resize(2, 0.0);
-
-    ks.resize(nbFrames);
 
-    for (int i = 0; i < nbFrames; ++i) {
-        D[i + 1].resize(frames[i].cands.size());
-        ks[i].resize(frames[i].cands.size());
-
-        for (int j = 0; j < (int) frames[i].cands.size(); ++j) {
-            double min = HUGE_VALF;
-            int kmin = 0;
-            for (int k = 0; k < (int) D[i].size(); ++k) {
-                double val = D[i][k] + i > 0 ? transitionMatrices[i][j][k] : 0.0;
+                double val = prevPathCost[k] + trans;
                 if (val < min) {
                     min = val;
                     kmin = k;
                 }
             }
-            
-            D[i + 1][j] = frames[i].cands[j].localCost + min;
-            ks[i][j] = kmin;
+        }
+
+        pathCost[j] = cj.localCost + min;
+        back[j] = kmin;
+
+        if (pathCost[j] < minCost) {
+            minCost = pathCost[j];
         }
     }
 
-    rpm::vector<double> pitches(nbFrames);
- 
-    const int nj = (int) D[1].size();
+    // Keep the accumulated costs bounded on long streams.
+    for (int j = 0; j < nj; ++j) {
+        pathCost[j] -= minCost;
+    }
+}
 
-    rpm::vector<int> indices(nj);
-    std::iota(indices.begin(), indices.end(), 0);
+double RAPT::decidePitch()
+{
+    const int delay = ringFrames - 1;
 
-    std::sort(indices.begin(), indices.end(),
-            [&](int j, int k) { return D[1][j] < D[1][k]; });
+    if (frameCount <= delay) {
+        return 0.0;
+    }
 
-    int k = indices[0];
+    int slot = (frameCount - 1) % ringFrames;
 
-    pitches[0] = frames[0].cands[k].voiced ? frames[0].Fs / frames[0].cands[k].L : 0.0;
+    int j = 0;
+    for (int k = 1; k < ringCounts[slot]; ++k) {
+        if (pathCost[k] < pathCost[j]) {
+            j = k;
+        }
+    }
 
-    for (int i = 1; i < nbFrames; ++i) {
-        k = ks[i][k];
-        
-        pitches[i] = frames[i].cands[k].voiced ? frames[i].Fs / frames[i].cands[k].L : 0.0;
+    // Trace the best partial path back to the frame being decided.
+    for (int i = 0; i < delay; ++i) {
+        j = ringBackPointers[slot * ringCands + j];
+        slot = (slot + ringFrames - 1) % ringFrames;
     }
 
-    return pitches;
+    return ringPitches[slot * ringCands + j];
 }
 
 // utility functions.
@@ -263,61 +306,104 @@ void subtractReferenceMean(rpm::vector<double>& s, int n, int K)
         s[j] -= mu;
 }
 
-rpm::vector<double> downsampleSignal(const rpm::vector<double>& s, const double Fs, const double Fds)
+void RAPT::downsampleSignal(const double Fs, const double Fds)
 {
     size_t olen = s.size() * Fds / Fs + 0.5;
     
-    rpm::vector<float> sFloat(s.begin(), s.end());
-    rpm::vector<float> outFloat(olen);
+    sFloat.assign(s.begin(), s.end());
+    dsFloat.resize(olen);
 
-    SRC_DATA data;
-    data.data_in = sFloat.data();
-    data.data_out = outFloat.data();
-    data.input_frames = sFloat.size();
-    data.output_frames = olen;
-    data.src_ratio = (double) Fds / (double) Fs;
+    int error = 0;
 
-    int error = src_simple(&data, SRC_SINC_MEDIUM_QUALITY, 1);
-    
-    if (error) {
-        throw std::runtime_error("Analysis::RAPT] could not downsample signal: " + std::string(src_strerror(error)));
+    // Equivalent to src_simple, but keeps the converter state across frames.
+    if (src == nullptr) {
+        src = src_new(SRC_SINC_MEDIUM_QUALITY, 1, &error);
     }
+    else {
+        error = src_reset(src);
+    }
+
+    if (!error) {
+        SRC_DATA data;
+        data.data_in = sFloat.data();
+        data.data_out = dsFloat.data();
+        data.input_frames = sFloat.size();
+        data.output_frames = olen;
+        data.src_ratio = (double) Fds / (double) Fs;
+        data.end_of_input = 1;
 
-    outFloat.resize(data.output_frames_gen);
+        error = src_process(src, &data);
+        
+        if (!error) {
+            dss.assign(dsFloat.begin(), std::next(dsFloat.begin(), data.output_frames_gen));
+        }
+    }
 
-    return rpm::vector<double>(outFloat.begin(), outFloat.end());
+    if (error) {
+        throw std::runtime_error("Analysis::RAPT] could not downsample signal: " + std::string(src_strerror(error)));
+    }
 }
 
-rpm::vector<double> calculateDownsampledNCCF(const rpm::vector<double>& dss, const int dsn, const int dsK1, const int dsK2)
+void RAPT::calculateDownsampledNCCF(const int dsn, const int dsK1, const int dsK2)
 {
-    rpm::vector<double> dsNCCF(dsK2 + 1, 0.0);
+    dsNCCF.assign(dsK2 + 1, 0.0);
+
+    // Cross-correlate the reference window with the whole lag range at once.
+    // The FFT only needs to cover dsn + dsK2 samples: no lag of interest wraps around.
+    const int nfft = pow2roundup(dsn + dsK2);
+
+    if (!xcorrFFT || xcorrFFT->getInputLength() != nfft) {
+        xcorrFFT = std::make_shared<RealFFT>(nfft);
+        refSpectrum.resize(xcorrFFT->getOutputLength());
+    }
+
+    auto& fft = *xcorrFFT;
+    const int nout = fft.getOutputLength();
+
+    const auto spectrum = fft.outputView();
+    const auto corr = fft.inputView();
+
+    fft.fillInput(dss.data(), dsn);
+    fft.computeForward();
+    for (int i = 0; i < nout; ++i) {
+        refSpectrum[i] = std::conj(spectrum[i]) / (double) nfft;
+    }
+
+    fft.fillInput(dss.data(), dsn + dsK2);
+    fft.computeForward();
+    for (int i = 0; i < nout; ++i) {
+        spectrum[i] *= refSpectrum[i];
+    }
+    fft.computeBackward();
 
     double dse0 = 0.0;
     for (int l = 0; l < dsn; ++l) {
         dse0 += dss[l] * dss[l];
     }
 
-    for (int k = dsK1; k <= dsK2; ++k) {
-        double p, q;
-        p = q = 0.0;
+    // Running energy of the lagged window. The updates cancel on near-silent stretches,
+    // so it is recomputed every few lags and floored relative to the reference energy.
+    constexpr int energyRefresh = 64;
+    const double qMin = 1e-12 * dse0;
 
-        for (int j = 0; j < dsn; ++j) {
-            p += dss[j] * dss[j + k];
-        }
+    double q = 0.0;
 
-        for (int l = k; l < k + dsn; ++l) {
-            q += dss[l] * dss[l];
+    for (int k = dsK1; k <= dsK2; ++k) {
+        if ((k - dsK1) % energyRefresh == 0) {
+            q = SIMD::dotProduct(dss.data() + k, dss.data() + k, dsn);
+        }
+        else {
+            q += dss[k + dsn - 1] * dss[k + dsn - 1] - dss[k - 1] * dss[k - 1];
         }
 
-        q = sqrtf(dse0 * q);
+        const double p = corr[k];
+        const double denom = dse0 * std::max(q, qMin);
 
-        dsNCCF[k] = p / q;
+        dsNCCF[k] = (denom > 0.0) ? p / sqrt(denom) : 0.0;
     }
-
-    return dsNCCF;
 }
 
-rpm::vector<std::pair<double, double>> findPeaksWithThreshold(const rpm::vector<double>& nccf, const double cand_tr, const int n_cands, const bool paraInterp)
+void findPeaksWithThreshold(const rpm::vector<double>& nccf, const double cand_tr, const int n_cands, const bool paraInterp, PeakFinder& finder, rpm::vector<std::pair<double, double>>& peaks)
 {
     double max = -HUGE_VALF;
     for (int i = 0; i < nccf.size(); ++i) {
@@ -328,9 +414,9 @@ rpm::vector<std::pair<double, double>> findPeaksWithThreshold(const rpm::vector<
 
     double threshold = cand_tr * max;
 
-    auto allPeaks = findPeaks(nccf.data(), (int) nccf.size());
+    const auto& allPeaks = finder.find(nccf.data(), (int) nccf.size());
 
-    rpm::vector<std::pair<double, double>> peaks;
+    peaks.clear();
 
     for (const int& k : allPeaks) {
         if (k >= 0 && k < nccf.size() && nccf[k] > threshold) {
@@ -349,63 +435,48 @@ rpm::vector<std::pair<double, double>> findPeaksWithThreshold(const rpm::vector<
     if (peaks.size() > n_cands - 1) {
         peaks.erase(std::next(peaks.begin(), n_cands - 1), peaks.end());
     }
-
-    return peaks;
 }
 
-rpm::vector<double> calculateOriginalNCCF(const rpm::vector<double>& s, const double Fs, const double Fds, const int n, const int K, const rpm::vector<std::pair<double, double>>& dsPeaks)
+void RAPT::calculateOriginalNCCF(const double Fs, const double Fds, const int n, const int K)
 {
-    rpm::set<int> lagsToCalculate;
+    lagMask.assign(K + 1, 0);
+
     for (const auto& [dsk, y] : dsPeaks) {
         const int k = std::round((Fs * dsk) / Fds);
        
-        if (k >= 0 && k <= K)
-            lagsToCalculate.emplace(k);
-
-        for (int l = 1; l <= 3; ++l) {
-            if (k - l >= 0 && k - l <= K)
-                lagsToCalculate.emplace(k - l);
-
+        for (int l = -3; l <= 3; ++l) {
             if (k + l >= 0 && k + l <= K)
-                lagsToCalculate.emplace(k + l);
+                lagMask[k + l] = 1;
         }
     }
     
-    rpm::vector<double> nccf(K + 1, 0.0);
-
-    double e0;
-    {
-        int j = 0;
-        double v = 0.0;
-        for (int l = j; l < j + n; ++l) {
-            v += s[l] * s[l];
-        }
-        e0 = v;
+    nccf.assign(K + 1, 0.0);
+
+    // Prefix sums of the squared signal give every window energy in O(1).
+    energy.resize(n + K + 1);
+    energy[0] = 0.0;
+    for (int l = 0; l < n + K; ++l) {
+        energy[l + 1] = energy[l] + s[l] * s[l];
     }
 
-    for (const int& k : lagsToCalculate) {
-        double p, q;
-        p = q = 0.0;
+    const double e0 = energy[n];
+    const double qMin = 1e-12 * e0;
 
-        for (int j = 0; j < n; ++j) {
-            p += s[j] * s[j + k];
-        }
+    for (int k = 0; k <= K; ++k) {
+        if (!lagMask[k])
+            continue;
 
-        for (int l = k; l < k + n; ++l) {
-            q += s[l] * s[l];
-        }
+        const double p = SIMD::dotProduct(s.data(), s.data() + k, n);
+        const double q = energy[k + n] - energy[k];
+        const double denom = e0 * std::max(q, qMin);
 
-        q = sqrtf(e0 * q);
-
-        nccf[k] = p / q;
+        nccf[k] = (denom > 0.0) ? p / sqrt(denom) : 0.0;
     }
-    
-    return nccf;
 }
 
-rpm::vector<RAPT::Cand> createCosts(const rpm::vector<std::pair<double, double>>& peaks, const double vo_bias, const double beta)
+void createCosts(const rpm::vector<std::pair<double, double>>& peaks, const double vo_bias, const double beta, rpm::vector<RAPT::Cand>& costs)
 {
-    rpm::vector<RAPT::Cand> costs(peaks.size() + 1);
+    costs.resize(peaks.size() + 1);
     
     int i = 0;
     for (const auto& [k, y] : peaks) {
@@ -423,7 +494,7 @@ rpm::vector<RAPT::Cand> createCosts(const rpm::vector<std::pair<double, double>>
     if (peaks.size() > 0) {
         maxCij = std::get<1>(
             *std::max_element(peaks.begin(), peaks.end(),
-                [](auto& x, auto& y) { return x.second > y.second; }));
+                [](auto& x, auto& y) { return x.second < y.second; }));
     }
 
     costs[i] = {
@@ -433,8 +504,6 @@ rpm::vector<RAPT::Cand> createCosts(const rpm::vector<std::pair<double, double>>
 
     std::sort(costs.begin(), costs.end(),
             [](const auto& a, const auto& b) { return a.localCost < b.localCost; });
-
-    return costs;
 }
 
 double calculateRMS(const rpm::vector<double>& s, const int start, const int length)
@@ -442,7 +511,7 @@ double calculateRMS(const rpm::vector<double>& s, const int start, const int len
     double sum = 0.0;
 
     for (int i = 0; i < length; ++i) {
-        double Wj = 0.5 - 0.5 * cos(2.0 * M_PI / (length - 1));
+        double Wj = 0.5 - 0.5 * cos((2.0 * M_PI * i) / (length - 1));
         double sj = s[start + i];
 
         double v = Wj * sj;
@@ -453,88 +522,89 @@ double calculateRMS(const rpm::vector<double>& s, const int start, const int len
     return (double) sqrt(sum / length);
 }
 
-double expDistItakura(const rpm::vector<double>& ar1, const rpm::vector<double>& ar2)
+double RAPT::expDistItakura(const rpm::vector<double>& ar1, const rpm::vector<double>& ar2)
 {
     // d = 2 * sum ( lpcar2rr (ar1) * m2 ) * (ar1[0] / ar2[0]) ^ 2
-    
+
+    const int p1 = (int) ar1.size();
+    const int p2 = (int) ar2.size();
+    const int p = std::max(p1, p2);
+
+    // Sized once for the LPC order, so that steady-state frames do not allocate.
+    distRa.resize(p);
+    distRr.resize(p);
+    distRf.resize(p);
+    distTemp.resize(p);
+    distA.resize(p);
+
     double denom = (ar1[0] * ar1[0]) / (ar2[0] * ar2[0]);
 
-    auto m2 = lpcar2ra(ar2);
+    double *m2 = distRa.data();
+    lpcar2ra(ar2.data(), p2, m2);
     m2[0] /= 2.0;
-    
-    auto rr1 = lpcar2rr(ar1);
+
+    double *rr1 = distRr.data();
+    lpcar2rr(ar1.data(), p1, rr1, distRf.data(), distTemp.data(), distA.data());
 
     double numer = 0.0;
 
-    for (int i = 0; i < m2.size(); ++i) {
+    for (int i = 0; i < std::min(p1, p2); ++i) {
         numer += m2[i] * rr1[i];
     }
 
     return 2.0 * numer / denom;
 }
 
-rpm::vector<double> lpcar2ra(const rpm::vector<double>& ar)
+void lpcar2ra(const double *ar, int p, double *ra)
 {
-    const int p = (int) ar.size();
-    
-    rpm::vector<double> ra(p);
-
     for (int i = 0; i < p; ++i) {
         ra[i] = 0.0;
         for (int j = 0; j < p - i; ++j) {
             ra[i] += ar[j] * ar[i + j];
         }
     }
-
-    return ra;
 }
 
-rpm::vector<double> lpcar2rr(const rpm::vector<double>& ar)
+void lpcar2rr(const double *ar, int p, double *rr, double *rf, double *temp, double *a)
 {
     double k = 1.0 / (ar[0] * ar[0]);
 
-    if (ar.size() == 1) {
-        return { k };
+    if (p == 1) {
+        rr[0] = k;
     }
     else {
-        rpm::vector<double> rr = lpcrf2rr(lpcar2rf(ar));
-        for (int i = 0; i < rr.size(); ++i) {
+        lpcar2rf(ar, p, rf, temp);
+        lpcrf2rr(rf, p, rr, a);
+        for (int i = 0; i < p; ++i) {
             rr[i] *= k;
         }
-        return rr;
     }
 }
 
-rpm::vector<double> lpcar2rf(const rpm::vector<double>& ar)
+void lpcar2rf(const double *ar, int p, double *rf, double *temp)
 {
-    const int p = (int) ar.size();
+    std::copy(ar, ar + p, rf);
 
-    rpm::vector<double> rf = ar;
-    
     for (int j = p - 2; j >= 1; --j) {
         double k = rf[j + 1];
         double d = 1.0 / (1.0 - k * k); 
-        
-        rpm::vector<double> temp = rf;
+
         for (int i = 1; i <= j; ++i) {
             temp[i] = (rf[i] - k * rf[j + 1 - i]) * d;
         }
-        rf = std::move(temp);
+        std::copy(temp + 1, temp + j + 1, rf + 1);
     }
-
-    return rf;
 }
 
-rpm::vector<double> lpcrf2rr(const rpm::vector<double>& rf)
+// a holds the p - 1 coefficients of the growing predictor.
+void lpcrf2rr(const double *rf, int p1, double *rr, double *a)
 {
-    const int p1 = (int) rf.size();
     const int p0 = p1 - 1;
 
     if (p0 > 0) {
-        rpm::vector<double> a;
-        a.push_back(rf[1]);
+        a[0] = rf[1];
 
-        rpm::vector<double> rr(p1, 0.0);
+        std::fill(rr, rr + p1, 0.0);
         rr[0] = 1.0;
         rr[1] = -a[0];
 
@@ -542,29 +612,32 @@ rpm::vector<double> lpcrf2rr(const rpm::vector<double>& rf)
         for (int n = 1; n < p0; ++n) {
             double k = rf[n + 1];
             rr[n + 1] = k * e;
-            for (int j = n - 1; j >= 1; --j) {
-                rr[n + 1] -= rr[j] * a[n - 1 - j];
+            for (int j = n; j >= 1; --j) {
+                rr[n + 1] -= rr[j] * a[n - j];
             }
-            for (int j = 0; j < a.size(); ++j) {
+            for (int j = 0; j < n / 2; ++j) {
+                const double aj = a[j];
                 a[j] += k * a[n - 1 - j];
+                a[n - 1 - j] += k * aj;
             }
-            a.push_back(k);
+            if (n % 2 == 1) {
+                a[n / 2] *= 1.0 + k;
+            }
+            a[n] = k;
             e *= (1.0 - k * k);
         }
         
         double r0 = rr[0];
-        for (int i = 1; i < a.size(); ++i) {
+        for (int i = 1; i <= p0; ++i) {
             r0 += rr[i] * a[i - 1];
         }
         r0 = 1.0 / r0;
 
-        for (int i = 0; i < rr.size(); ++i) {
+        for (int i = 0; i < p1; ++i) {
             rr[i] *= r0;
         }
-
-        return rr;
     }
     else {
-        return { 1.0 };
+        rr[0] = 1.0;
     }
 }
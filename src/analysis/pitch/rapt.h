@@ -3,15 +3,23 @@
 
 #include "rpcxx.h"
 #include "../linpred/linpred.h"
+#include "../fft/fft.h"
+#include "../util/util.h"
+#include <samplerate.h>
+#include <memory>
+#include <cstdint>
 
 namespace Analysis {
 
     class RAPT {
     public:
         RAPT();
+        ~RAPT();
 
+        // Returns the pitch decided for the frame submitted `lookahead` calls ago,
+        // or 0 if that frame is unvoiced or not available yet.
         double computeFrame(const double *data, int length, double sampleRate);
-        rpm::vector<double> computePath();
+        void resetTracking();
 
         double F0min;    // minimum F0 to search for (Hz)                | 50
         double F0max;    // maximum F0 to search for (Hz)                | 500
@@ -34,24 +42,55 @@ namespace Analysis {
             double rms;       // RMS of candidate
         };
     
-        struct Frame {
-            rpm::vector<Cand> cands;
-           
-            double Fs;
-
-            double rms;
-            double rr;
-
-            rpm::vector<double> ar;
-            double S;
-        };
-
         LP::Autocorr lpc;
         int lpcOrder;
-        int nbFrames;
+        int lookahead;   // frames of delay before the Viterbi decision   | 5
 
     private:
-        rpm::deque<Frame> frames;
+        void downsampleSignal(double Fs, double Fds);
+        void calculateDownsampledNCCF(int dsn, int dsK1, int dsK2);
+        void calculateOriginalNCCF(double Fs, double Fds, int n, int K);
+        void updatePath(double rr, double S);
+        double decidePitch();
+        double expDistItakura(const rpm::vector<double>& ar1, const rpm::vector<double>& ar2);
+
+        // Online Viterbi state: ring buffers of lookahead + 1 frames, n_cands each.
+        int ringFrames;
+        int ringCands;
+        int64_t frameCount;
+        rpm::vector<Cand> ringCandidates;
+        rpm::vector<double> ringPitches;
+        rpm::vector<int> ringCounts;
+        rpm::vector<int> ringBackPointers;
+        rpm::vector<double> pathCost;
+        rpm::vector<double> prevPathCost;
+        double prevRms;
+        rpm::vector<double> prevAr;
+        rpm::vector<double> ar;
+        rpm::vector<Cand> cands;
+
+        // Scratch for expDistItakura, one LPC order + 1 long each.
+        rpm::vector<double> distRa;
+        rpm::vector<double> distRr;
+        rpm::vector<double> distRf;
+        rpm::vector<double> distTemp;
+        rpm::vector<double> distA;
+
+        // Scratch buffers reused across frames.
+        rpm::vector<double> s;
+        rpm::vector<float> sFloat;
+        rpm::vector<float> dsFloat;
+        rpm::vector<double> dss;
+        rpm::vector<double> dsNCCF;
+        rpm::vector<double> nccf;
+        rpm::vector<double> energy;
+        rpm::vector<uint8_t> lagMask;
+        rpm::vector<std::pair<double, double>> dsPeaks;
+        rpm::vector<std::pair<double, double>> peaks;
+        PeakFinder peakFinder;
+        rpm::vector<std::dcomplex> refSpectrum;
+        std::shared_ptr<RealFFT> xcorrFFT;
+        SRC_STATE *src;
     };
 }
 
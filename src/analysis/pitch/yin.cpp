@@ -1,4 +1,5 @@
 #include "pitch.h"
+#include "../simd/simd.h"
 
 using Analysis::PitchResult;
 using namespace Analysis::Pitch;
@@ -17,61 +18,195 @@ pow2roundup (int x)
     return x+1;
 }
 
-Yin::Yin(double threshold)
-    : mThreshold(threshold),
-      mFFT(nullptr)
+// The difference function, its cumulative mean normalisation and the
+// absolute threshold search are fused into a single pass over the lags.
+// Each kernel writes cmnd[0..k] and returns the first lag k >= 2 below
+// the threshold, walked down to the bottom of its dip, or n if none.
+
+static int cmndThresholdFrom(const double *r, double *cmnd, int tau, int n, double threshold, double runningSum, int k)
 {
+    const double r01 = r[0] + r[1];
+
+    for (; tau < n; ++tau) {
+        const double d = r01 - 2 * r[tau];
+        runningSum += d;
+        cmnd[tau] = (tau * d) / runningSum;
+
+        if (k < 0) {
+            if (tau >= 2 && cmnd[tau] < threshold)
+                k = tau;
+        }
+        else if (cmnd[tau] < cmnd[k]) {
+            k = tau;
+        }
+        else {
+            return k;
+        }
+    }
+
+    return k < 0 ? n : k;
 }
 
-PitchResult Yin::solve(const double *data, int length, int sampleRate) 
+static int cmndThresholdScalar(const double *r, double *cmnd, int n, double threshold)
 {
-    int nfft = pow2roundup(length);
+    cmnd[0] = 1.0;
+    return cmndThresholdFrom(r, cmnd, 1, n, threshold, 0.0, -1);
+}
 
-    if (!mFFT || mFFT->getLength() != nfft) {
-        mFFT = std::make_shared<ComplexFFT>(nfft);
-    }
+#if defined(ANALYSIS_SIMD_AVX2)
 
-    for (int i = 0; i < length; ++i) {
-        mFFT->data(i) = data[i];
-    }
-    for (int i = length; i < nfft; ++i) {
-        mFFT->data(i) = 0.0;
-    }
-    mFFT->computeForward();
-    for (int i = 0; i < nfft; ++i) {
-        std::dcomplex z = mFFT->data(i);
-        mFFT->data(i) = (z * conj(z)) / (double) nfft;
+ANALYSIS_TARGET_AVX2
+static int cmndThresholdAVX2(const double *r, double *cmnd, int n, double threshold)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d r01 = _mm256_set1_pd(r[0] + r[1]);
+    const __m256d thr = _mm256_set1_pd(threshold);
+
+    __m256d lag = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+    __m256d carry = zero;
+
+    int k = -1;
+    int tau = 0;
+
+    for (; tau + 4 <= n; tau += 4) {
+        __m256d d = _mm256_fnmadd_pd(two, _mm256_loadu_pd(r + tau), r01);
+        if (tau == 0) {
+            d = _mm256_blend_pd(d, zero, 0x1);
+        }
+
+        // In-register inclusive prefix sum, then add the running total.
+        __m256d s = _mm256_add_pd(d, _mm256_blend_pd(_mm256_permute4x64_pd(d, 0x90), zero, 0x1));
+        s = _mm256_add_pd(s, _mm256_permute2f128_pd(s, s, 0x08));
+        s = _mm256_add_pd(s, carry);
+        carry = _mm256_permute4x64_pd(s, 0xFF);
+
+        __m256d c = _mm256_div_pd(_mm256_mul_pd(lag, d), s);
+        if (tau == 0) {
+            c = _mm256_blend_pd(c, one, 0x1);
+        }
+        _mm256_storeu_pd(cmnd + tau, c);
+        lag = _mm256_add_pd(lag, four);
+
+        if (k < 0) {
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(c, thr, _CMP_LT_OQ));
+            if (tau == 0) {
+                mask &= ~0x3;
+            }
+            if (mask == 0) {
+                continue;
+            }
+            k = tau + Analysis::SIMD::countTrailingZeros(mask);
+        }
+
+        while (k + 1 < tau + 4 && cmnd[k + 1] < cmnd[k]) {
+            k++;
+        }
+        if (k + 1 < tau + 4) {
+            return k;
+        }
     }
-    mFFT->computeBackward();
 
-    mAutocorrelation.resize(length);
-    for (int i = 0; i < length; ++i) {
-        mAutocorrelation[i] = mFFT->data(i).real();
+    if (tau == 0) {
+        return cmndThresholdScalar(r, cmnd, n, threshold);
     }
 
-    mDifference.resize(length / 2);
-    for (int tau = 0; tau < length / 2; ++tau) {
-        mDifference[tau] = mAutocorrelation[0] + mAutocorrelation[1] - 2 * mAutocorrelation[tau];
+    return cmndThresholdFrom(r, cmnd, tau, n, threshold, _mm256_cvtsd_f64(carry), k);
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static int cmndThresholdNEON(const double *r, double *cmnd, int n, double threshold)
+{
+    const float64x2_t zero = vdupq_n_f64(0.0);
+    const float64x2_t two = vdupq_n_f64(2.0);
+    const float64x2_t r01 = vdupq_n_f64(r[0] + r[1]);
+    const float64x2_t thr = vdupq_n_f64(threshold);
+
+    float64x2_t lag = vsetq_lane_f64(1.0, zero, 1);
+    float64x2_t carry = zero;
+
+    int k = -1;
+    int tau = 0;
+
+    for (; tau + 2 <= n; tau += 2) {
+        float64x2_t d = vfmsq_f64(r01, two, vld1q_f64(r + tau));
+        if (tau == 0) {
+            d = vsetq_lane_f64(0.0, d, 0);
+        }
+
+        float64x2_t s = vaddq_f64(d, vextq_f64(zero, d, 1));
+        s = vaddq_f64(s, carry);
+        carry = vdupq_laneq_f64(s, 1);
+
+        float64x2_t c = vdivq_f64(vmulq_f64(lag, d), s);
+        if (tau == 0) {
+            c = vsetq_lane_f64(1.0, c, 0);
+        }
+        vst1q_f64(cmnd + tau, c);
+        lag = vaddq_f64(lag, two);
+
+        if (k < 0) {
+            const uint64x2_t lt = vcltq_f64(c, thr);
+            if (tau == 0 || (vgetq_lane_u64(lt, 0) | vgetq_lane_u64(lt, 1)) == 0) {
+                continue;
+            }
+            k = vgetq_lane_u64(lt, 0) ? tau : tau + 1;
+        }
+
+        while (k + 1 < tau + 2 && cmnd[k + 1] < cmnd[k]) {
+            k++;
+        }
+        if (k + 1 < tau + 2) {
+            return k;
+        }
     }
 
-    mCMND.resize(length / 2);
-    double runningSum = 0.0;
-    mCMND[0] = 1.0;
-    for (int tau = 1; tau < length / 2; ++tau) {
-        runningSum += mDifference[tau];
-        mCMND[tau] = (tau * mDifference[tau]) / runningSum;
+    if (tau == 0) {
+        return cmndThresholdScalar(r, cmnd, n, threshold);
     }
 
-    int k;
-    for (k = 2; k < length / 2; ++k) {
-        if (mCMND[k] < mThreshold) {
-            while (k + 1 < length / 2 && mCMND[k + 1] < mCMND[k])
-                k++;
-            break;
-        }
+    return cmndThresholdFrom(r, cmnd, tau, n, threshold, vgetq_lane_f64(carry, 0), k);
+}
+
+#endif
+
+using CMNDKernel = int (*)(const double *, double *, int, double);
+
+static CMNDKernel selectCMNDKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return cmndThresholdAVX2;
     }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return cmndThresholdNEON;
+#endif
+    return cmndThresholdScalar;
+}
+
+static const CMNDKernel cmndThreshold = selectCMNDKernel();
+
+Yin::Yin(double threshold)
+    : mThreshold(threshold)
+{
+}
+
+PitchResult Yin::solve(const double *data, int length, int sampleRate) 
+{
+    int nfft = pow2roundup(length);
+
+    auto& frame = spectralFrames().get(sampleRate, nfft, SpectralWindow::Rectangular, data, length);
+    const auto& acf = frame.autocorrelation();
+
+    const int n = length / 2;
+
+    mCMND.resize(n);
+    int k = n >= 2 ? cmndThreshold(acf.data(), mCMND.data(), n, mThreshold) : n;
 
-    if (k == length / 2 || mCMND[k] >= mThreshold) {
+    if (k == n || mCMND[k] >= mThreshold) {
         return {0.0, false};
     }
     else {
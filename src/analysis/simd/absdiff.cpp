@@ -0,0 +1,94 @@
+#include "simd.h"
+#include <cmath>
+
+static double absDiffSumScalar(const double *x, const double *y, int n)
+{
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        sum += std::abs(x[i] - y[i]);
+    }
+    return sum;
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+ANALYSIS_TARGET_AVX2
+static double absDiffSumAVX2(const double *x, const double *y, int n)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    __m256d acc3 = _mm256_setzero_pd();
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i),      _mm256_loadu_pd(y + i))));
+        acc1 = _mm256_add_pd(acc1, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i + 4),  _mm256_loadu_pd(y + i + 4))));
+        acc2 = _mm256_add_pd(acc2, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i + 8),  _mm256_loadu_pd(y + i + 8))));
+        acc3 = _mm256_add_pd(acc3, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12))));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i))));
+    }
+
+    const __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+
+    for (; i < n; ++i) {
+        sum += std::abs(x[i] - y[i]);
+    }
+    return sum;
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static double absDiffSumNEON(const double *x, const double *y, int n)
+{
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    float64x2_t acc2 = vdupq_n_f64(0.0);
+    float64x2_t acc3 = vdupq_n_f64(0.0);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vaddq_f64(acc0, vabdq_f64(vld1q_f64(x + i),     vld1q_f64(y + i)));
+        acc1 = vaddq_f64(acc1, vabdq_f64(vld1q_f64(x + i + 2), vld1q_f64(y + i + 2)));
+        acc2 = vaddq_f64(acc2, vabdq_f64(vld1q_f64(x + i + 4), vld1q_f64(y + i + 4)));
+        acc3 = vaddq_f64(acc3, vabdq_f64(vld1q_f64(x + i + 6), vld1q_f64(y + i + 6)));
+    }
+    for (; i + 2 <= n; i += 2) {
+        acc0 = vaddq_f64(acc0, vabdq_f64(vld1q_f64(x + i), vld1q_f64(y + i)));
+    }
+
+    double sum = vaddvq_f64(vaddq_f64(vaddq_f64(acc0, acc1), vaddq_f64(acc2, acc3)));
+
+    for (; i < n; ++i) {
+        sum += std::abs(x[i] - y[i]);
+    }
+    return sum;
+}
+
+#endif
+
+using AbsDiffSumKernel = double (*)(const double *, const double *, int);
+
+static AbsDiffSumKernel selectAbsDiffSumKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return absDiffSumAVX2;
+    }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return absDiffSumNEON;
+#endif
+    return absDiffSumScalar;
+}
+
+double Analysis::SIMD::absDiffSum(const double *x, const double *y, int n)
+{
+    static const AbsDiffSumKernel kernel = selectAbsDiffSumKernel();
+    return kernel(x, y, n);
+}
@@ -0,0 +1,53 @@
+#ifndef ANALYSIS_SIMD_ALIGNED_H
+#define ANALYSIS_SIMD_ALIGNED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace Analysis::SIMD {
+
+    // Allocator for buffers that kernels stream through, aligned to a cache line.
+    // Over-allocates and keeps the original pointer just before the aligned block,
+    // so it does not depend on aligned operator new being available.
+    template<typename T, std::size_t Alignment = 64>
+    class AlignedAllocator {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept {}
+
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T *allocate(std::size_t n)
+        {
+            void *raw = ::operator new(n * sizeof(T) + Alignment + sizeof(void *));
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+            addr = (addr + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+            reinterpret_cast<void **>(addr)[-1] = raw;
+            return reinterpret_cast<T *>(addr);
+        }
+
+        void deallocate(T *p, std::size_t) noexcept
+        {
+            ::operator delete(reinterpret_cast<void **>(p)[-1]);
+        }
+    };
+
+    template<typename T, typename U, std::size_t Alignment>
+    inline bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return true; }
+
+    template<typename T, typename U, std::size_t Alignment>
+    inline bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return false; }
+
+    template<typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+}
+
+#endif // ANALYSIS_SIMD_ALIGNED_H
@@ -0,0 +1,121 @@
+#include "simd.h"
+#include <algorithm>
+
+// Sum of x[i] * x[i - lag] for i in [from, to).
+static double lagSum(const double *x, int lag, int from, int to)
+{
+    double sum = 0.0;
+    for (int i = from; i < to; ++i) {
+        sum += x[i] * x[i - lag];
+    }
+    return sum;
+}
+
+static void autocorrelationScalar(const double *x, int n, int maxLag, double *r)
+{
+    for (int j = 0; j <= maxLag; ++j) {
+        r[j] = lagSum(x, j, j, n);
+    }
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+ANALYSIS_TARGET_AVX2
+static inline double horizontalSum(__m256d v)
+{
+    const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+ANALYSIS_TARGET_AVX2
+static void autocorrelationAVX2(const double *x, int n, int maxLag, double *r)
+{
+    // Lags are done four at a time, so each load of x[i..i+3] feeds four FMAs.
+    int j0 = 0;
+    for (; j0 + 4 <= maxLag + 1; j0 += 4) {
+        const int start = j0 + 3;
+
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd();
+        __m256d acc3 = _mm256_setzero_pd();
+
+        int i = start;
+        for (; i + 4 <= n; i += 4) {
+            const __m256d xi = _mm256_loadu_pd(x + i);
+            acc0 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(x + i - j0),     acc0);
+            acc1 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(x + i - j0 - 1), acc1);
+            acc2 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(x + i - j0 - 2), acc2);
+            acc3 = _mm256_fmadd_pd(xi, _mm256_loadu_pd(x + i - j0 - 3), acc3);
+        }
+
+        // The lower lags of the block also start before the shared range.
+        const int head = std::min(start, n);
+
+        r[j0]     = horizontalSum(acc0) + lagSum(x, j0,     j0,     head) + lagSum(x, j0,     i, n);
+        r[j0 + 1] = horizontalSum(acc1) + lagSum(x, j0 + 1, j0 + 1, head) + lagSum(x, j0 + 1, i, n);
+        r[j0 + 2] = horizontalSum(acc2) + lagSum(x, j0 + 2, j0 + 2, head) + lagSum(x, j0 + 2, i, n);
+        r[j0 + 3] = horizontalSum(acc3) + lagSum(x, j0 + 3, j0 + 3, head) + lagSum(x, j0 + 3, i, n);
+    }
+
+    for (int j = j0; j <= maxLag; ++j) {
+        r[j] = lagSum(x, j, j, n);
+    }
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static void autocorrelationNEON(const double *x, int n, int maxLag, double *r)
+{
+    int j0 = 0;
+    for (; j0 + 4 <= maxLag + 1; j0 += 4) {
+        const int start = j0 + 3;
+
+        float64x2_t acc0 = vdupq_n_f64(0.0);
+        float64x2_t acc1 = vdupq_n_f64(0.0);
+        float64x2_t acc2 = vdupq_n_f64(0.0);
+        float64x2_t acc3 = vdupq_n_f64(0.0);
+
+        int i = start;
+        for (; i + 2 <= n; i += 2) {
+            const float64x2_t xi = vld1q_f64(x + i);
+            acc0 = vfmaq_f64(acc0, xi, vld1q_f64(x + i - j0));
+            acc1 = vfmaq_f64(acc1, xi, vld1q_f64(x + i - j0 - 1));
+            acc2 = vfmaq_f64(acc2, xi, vld1q_f64(x + i - j0 - 2));
+            acc3 = vfmaq_f64(acc3, xi, vld1q_f64(x + i - j0 - 3));
+        }
+
+        const int head = std::min(start, n);
+
+        r[j0]     = vaddvq_f64(acc0) + lagSum(x, j0,     j0,     head) + lagSum(x, j0,     i, n);
+        r[j0 + 1] = vaddvq_f64(acc1) + lagSum(x, j0 + 1, j0 + 1, head) + lagSum(x, j0 + 1, i, n);
+        r[j0 + 2] = vaddvq_f64(acc2) + lagSum(x, j0 + 2, j0 + 2, head) + lagSum(x, j0 + 2, i, n);
+        r[j0 + 3] = vaddvq_f64(acc3) + lagSum(x, j0 + 3, j0 + 3, head) + lagSum(x, j0 + 3, i, n);
+    }
+
+    for (int j = j0; j <= maxLag; ++j) {
+        r[j] = lagSum(x, j, j, n);
+    }
+}
+
+#endif
+
+using AutocorrelationKernel = void (*)(const double *, int, int, double *);
+
+static AutocorrelationKernel selectAutocorrelationKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return autocorrelationAVX2;
+    }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return autocorrelationNEON;
+#endif
+    return autocorrelationScalar;
+}
+
+void Analysis::SIMD::autocorrelation(const double *x, int n, int maxLag, double *r)
+{
+    static const AutocorrelationKernel kernel = selectAutocorrelationKernel();
+    kernel(x, n, maxLag, r);
+}
@@ -0,0 +1,158 @@
+#include "simd.h"
+
+template<typename T>
+static void burgStageScalar(T *f, T *b, T k, int n, T *pNum, T *pDen)
+{
+    T num = 0, den = 0;
+    for (int j = 0; j < n; ++j) {
+        const T fj = f[j] - k * b[j];
+        const T bj = b[j + 1] - k * f[j + 1];
+        f[j] = fj;
+        b[j] = bj;
+        num += fj * bj;
+        den += fj * fj + bj * bj;
+    }
+    *pNum = num;
+    *pDen = den;
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+ANALYSIS_TARGET_AVX2
+static void burgStageAVX2(double *f, double *b, double k, int n, double *pNum, double *pDen)
+{
+    const __m256d vk = _mm256_set1_pd(k);
+    __m256d num = _mm256_setzero_pd();
+    __m256d den = _mm256_setzero_pd();
+
+    // Each block reads f[j + 1..j + 4] and b[j + 1..j + 4] before they are overwritten,
+    // which keeps the in-place update equal to the sequential one.
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const __m256d fj = _mm256_fnmadd_pd(vk, _mm256_loadu_pd(b + j), _mm256_loadu_pd(f + j));
+        const __m256d bj = _mm256_fnmadd_pd(vk, _mm256_loadu_pd(f + j + 1), _mm256_loadu_pd(b + j + 1));
+        _mm256_storeu_pd(f + j, fj);
+        _mm256_storeu_pd(b + j, bj);
+        num = _mm256_fmadd_pd(fj, bj, num);
+        den = _mm256_fmadd_pd(fj, fj, _mm256_fmadd_pd(bj, bj, den));
+    }
+
+    const __m128d numHalf = _mm_add_pd(_mm256_castpd256_pd128(num), _mm256_extractf128_pd(num, 1));
+    const __m128d denHalf = _mm_add_pd(_mm256_castpd256_pd128(den), _mm256_extractf128_pd(den, 1));
+
+    double tailNum, tailDen;
+    burgStageScalar(f + j, b + j, k, n - j, &tailNum, &tailDen);
+
+    *pNum = _mm_cvtsd_f64(_mm_add_sd(numHalf, _mm_unpackhi_pd(numHalf, numHalf))) + tailNum;
+    *pDen = _mm_cvtsd_f64(_mm_add_sd(denHalf, _mm_unpackhi_pd(denHalf, denHalf))) + tailDen;
+}
+
+ANALYSIS_TARGET_AVX2
+static void burgStageAVX2(float *f, float *b, float k, int n, float *pNum, float *pDen)
+{
+    const __m256 vk = _mm256_set1_ps(k);
+    __m256 num = _mm256_setzero_ps();
+    __m256 den = _mm256_setzero_ps();
+
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m256 fj = _mm256_fnmadd_ps(vk, _mm256_loadu_ps(b + j), _mm256_loadu_ps(f + j));
+        const __m256 bj = _mm256_fnmadd_ps(vk, _mm256_loadu_ps(f + j + 1), _mm256_loadu_ps(b + j + 1));
+        _mm256_storeu_ps(f + j, fj);
+        _mm256_storeu_ps(b + j, bj);
+        num = _mm256_fmadd_ps(fj, bj, num);
+        den = _mm256_fmadd_ps(fj, fj, _mm256_fmadd_ps(bj, bj, den));
+    }
+
+    alignas(32) float numLanes[8], denLanes[8];
+    _mm256_store_ps(numLanes, num);
+    _mm256_store_ps(denLanes, den);
+
+    float tailNum, tailDen;
+    burgStageScalar(f + j, b + j, k, n - j, &tailNum, &tailDen);
+
+    for (int l = 0; l < 8; ++l) {
+        tailNum += numLanes[l];
+        tailDen += denLanes[l];
+    }
+    *pNum = tailNum;
+    *pDen = tailDen;
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static void burgStageNEON(double *f, double *b, double k, int n, double *pNum, double *pDen)
+{
+    const float64x2_t vk = vdupq_n_f64(k);
+    float64x2_t num = vdupq_n_f64(0.0);
+    float64x2_t den = vdupq_n_f64(0.0);
+
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        const float64x2_t fj = vfmsq_f64(vld1q_f64(f + j), vk, vld1q_f64(b + j));
+        const float64x2_t bj = vfmsq_f64(vld1q_f64(b + j + 1), vk, vld1q_f64(f + j + 1));
+        vst1q_f64(f + j, fj);
+        vst1q_f64(b + j, bj);
+        num = vfmaq_f64(num, fj, bj);
+        den = vfmaq_f64(vfmaq_f64(den, fj, fj), bj, bj);
+    }
+
+    double tailNum, tailDen;
+    burgStageScalar(f + j, b + j, k, n - j, &tailNum, &tailDen);
+
+    *pNum = vaddvq_f64(num) + tailNum;
+    *pDen = vaddvq_f64(den) + tailDen;
+}
+
+static void burgStageNEON(float *f, float *b, float k, int n, float *pNum, float *pDen)
+{
+    const float32x4_t vk = vdupq_n_f32(k);
+    float32x4_t num = vdupq_n_f32(0.0f);
+    float32x4_t den = vdupq_n_f32(0.0f);
+
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const float32x4_t fj = vfmsq_f32(vld1q_f32(f + j), vk, vld1q_f32(b + j));
+        const float32x4_t bj = vfmsq_f32(vld1q_f32(b + j + 1), vk, vld1q_f32(f + j + 1));
+        vst1q_f32(f + j, fj);
+        vst1q_f32(b + j, bj);
+        num = vfmaq_f32(num, fj, bj);
+        den = vfmaq_f32(vfmaq_f32(den, fj, fj), bj, bj);
+    }
+
+    float tailNum, tailDen;
+    burgStageScalar(f + j, b + j, k, n - j, &tailNum, &tailDen);
+
+    *pNum = vaddvq_f32(num) + tailNum;
+    *pDen = vaddvq_f32(den) + tailDen;
+}
+
+#endif
+
+template<typename T>
+using BurgStageKernel = void (*)(T *, T *, T, int, T *, T *);
+
+template<typename T>
+static BurgStageKernel<T> selectBurgStageKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return burgStageAVX2;
+    }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return burgStageNEON;
+#endif
+    return burgStageScalar<T>;
+}
+
+void Analysis::SIMD::burgStage(double *f, double *b, double k, int n, double *num, double *den)
+{
+    static const BurgStageKernel<double> kernel = selectBurgStageKernel<double>();
+    kernel(f, b, k, n, num, den);
+}
+
+void Analysis::SIMD::burgStage(float *f, float *b, float k, int n, float *num, float *den)
+{
+    static const BurgStageKernel<float> kernel = selectBurgStageKernel<float>();
+    kernel(f, b, k, n, num, den);
+}
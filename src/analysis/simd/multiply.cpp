@@ -0,0 +1,62 @@
+#include "simd.h"
+
+static void multiplyScalar(const double *x, const double *y, double *out, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        out[i] = x[i] * y[i];
+    }
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+ANALYSIS_TARGET_AVX2
+static void multiplyAVX2(const double *x, const double *y, double *out, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_pd(out + i,     _mm256_mul_pd(_mm256_loadu_pd(x + i),     _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] = x[i] * y[i];
+    }
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static void multiplyNEON(const double *x, const double *y, double *out, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f64(out + i,     vmulq_f64(vld1q_f64(x + i),     vld1q_f64(y + i)));
+        vst1q_f64(out + i + 2, vmulq_f64(vld1q_f64(x + i + 2), vld1q_f64(y + i + 2)));
+    }
+    for (; i < n; ++i) {
+        out[i] = x[i] * y[i];
+    }
+}
+
+#endif
+
+using MultiplyKernel = void (*)(const double *, const double *, double *, int);
+
+static MultiplyKernel selectMultiplyKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return multiplyAVX2;
+    }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return multiplyNEON;
+#endif
+    return multiplyScalar;
+}
+
+void Analysis::SIMD::multiply(const double *x, const double *y, double *out, int n)
+{
+    static const MultiplyKernel kernel = selectMultiplyKernel();
+    kernel(x, y, out, n);
+}
@@ -0,0 +1,106 @@
+#include "simd.h"
+
+static inline uint64_t shiftedWord(const uint64_t *b, int shift, int k)
+{
+    return shift == 0 ? b[k] : (b[k] >> shift) | (b[k + 1] << (64 - shift));
+}
+
+static int64_t andPopCountScalar(const uint64_t *a, const uint64_t *b, int shift, int n)
+{
+    int64_t sum = 0;
+    for (int k = 0; k < n; ++k) {
+        sum += Analysis::SIMD::popCount64(a[k] & shiftedWord(b, shift, k));
+    }
+    return sum;
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+// Nibble lookup popcount, summed per 64-bit lane with SAD.
+ANALYSIS_TARGET_AVX2
+static int64_t andPopCountAVX2(const uint64_t *a, const uint64_t *b, int shift, int n)
+{
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+
+    // Shifting by 64 yields zero, which handles shift == 0 without a branch.
+    const __m128i sr = _mm_cvtsi32_si128(shift);
+    const __m128i sl = _mm_cvtsi32_si128(64 - shift);
+
+    __m256i acc = _mm256_setzero_si256();
+
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        const __m256i va = _mm256_loadu_si256((const __m256i *) (a + k));
+        const __m256i b0 = _mm256_loadu_si256((const __m256i *) (b + k));
+        const __m256i b1 = _mm256_loadu_si256((const __m256i *) (b + k + 1));
+        const __m256i vb = _mm256_or_si256(_mm256_srl_epi64(b0, sr), _mm256_sll_epi64(b1, sl));
+        const __m256i v = _mm256_and_si256(va, vb);
+
+        const __m256i lo = _mm256_and_si256(v, lowMask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+        const __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, zero));
+    }
+
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256((__m256i *) lanes, acc);
+    int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    for (; k < n; ++k) {
+        sum += Analysis::SIMD::popCount64(a[k] & shiftedWord(b, shift, k));
+    }
+    return sum;
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static int64_t andPopCountNEON(const uint64_t *a, const uint64_t *b, int shift, int n)
+{
+    // Shifting left by 64 yields zero, which handles shift == 0 without a branch.
+    const int64x2_t sr = vdupq_n_s64(-shift);
+    const int64x2_t sl = vdupq_n_s64(64 - shift);
+
+    uint64x2_t acc = vdupq_n_u64(0);
+
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        const uint64x2_t va = vld1q_u64(a + k);
+        const uint64x2_t vb = vorrq_u64(vshlq_u64(vld1q_u64(b + k), sr), vshlq_u64(vld1q_u64(b + k + 1), sl));
+        const uint8x16_t cnt = vcntq_u8(vreinterpretq_u8_u64(vandq_u64(va, vb)));
+
+        acc = vaddq_u64(acc, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(cnt))));
+    }
+
+    int64_t sum = (int64_t) vaddvq_u64(acc);
+
+    for (; k < n; ++k) {
+        sum += Analysis::SIMD::popCount64(a[k] & shiftedWord(b, shift, k));
+    }
+    return sum;
+}
+
+#endif
+
+using AndPopCountKernel = int64_t (*)(const uint64_t *, const uint64_t *, int, int);
+
+static AndPopCountKernel selectAndPopCountKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return andPopCountAVX2;
+    }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return andPopCountNEON;
+#endif
+    return andPopCountScalar;
+}
+
+int64_t Analysis::SIMD::andPopCount(const uint64_t *a, const uint64_t *b, int shift, int n)
+{
+    static const AndPopCountKernel kernel = selectAndPopCountKernel();
+    return kernel(a, b, shift, n);
+}
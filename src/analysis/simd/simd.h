@@ -0,0 +1,82 @@
+#ifndef ANALYSIS_SIMD_H
+#define ANALYSIS_SIMD_H
+
+// Kernels are compiled for AVX2+FMA with per-function target attributes
+// and picked at runtime, so the baseline build flags stay untouched.
+// On AArch64 NEON is always available and is used unconditionally.
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#   if defined(__GNUC__) || defined(__clang__)
+#       define ANALYSIS_SIMD_AVX2 1
+#       define ANALYSIS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#   elif defined(_MSC_VER)
+#       define ANALYSIS_SIMD_AVX2 1
+#       define ANALYSIS_TARGET_AVX2
+#   endif
+#   include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#   define ANALYSIS_SIMD_NEON 1
+#   include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+#include <cstdint>
+
+namespace Analysis::SIMD {
+
+    bool hasAVX2();
+
+    double dotProduct(const double *x, const double *y, int n);
+
+    // out[i] = x[i] * y[i] over n elements. out may alias x or y.
+    void multiply(const double *x, const double *y, double *out, int n);
+
+    // CSR matrix-vector product: y[r] = sum of values[j] * x[columns[j]]
+    // over j in [rowStart[r], rowStart[r + 1]), for every row r in [0, rows).
+    void sparseMatVec(const int *rowStart, const int *columns, const double *values, int rows,
+                      const double *x, double *y);
+
+    // r[j] = sum of x[i] * x[i - j] over i in [j, n), for every lag j from 0 to maxLag.
+    void autocorrelation(const double *x, int n, int maxLag, double *r);
+
+    // One stage of Burg's recursion over n elements, in place:
+    //   f[j] <- f[j] - k * b[j],  b[j] <- b[j + 1] - k * f[j + 1]  (right-hand sides before the update)
+    // and the sums of f * b and f^2 + b^2 over the updated values. f[n] and b[n] must be readable.
+    void burgStage(double *f, double *b, double k, int n, double *num, double *den);
+    void burgStage(float *f, float *b, float k, int n, float *num, float *den);
+
+    // Sum of |x[i] - y[i]| over n elements.
+    double absDiffSum(const double *x, const double *y, int n);
+
+    // Number of bits set in a[k] & (b >> shift)[k] over n words, where b is read
+    // as one little-endian bit stream. b[n] must be readable. 0 <= shift < 64.
+    int64_t andPopCount(const uint64_t *a, const uint64_t *b, int shift, int n);
+
+    inline int countTrailingZeros(unsigned int x)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return (int) index;
+#else
+        return __builtin_ctz(x);
+#endif
+    }
+
+    inline int popCount64(uint64_t x)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return (int) __popcnt64(x);
+#elif defined(_MSC_VER)
+        return (int) (__popcnt((uint32_t) x) + __popcnt((uint32_t) (x >> 32)));
+#else
+        return __builtin_popcountll(x);
+#endif
+    }
+
+}
+
+#endif // ANALYSIS_SIMD_H
@@ -0,0 +1,100 @@
+#include "simd.h"
+
+static void sparseMatVecScalar(const int *rowStart, const int *columns, const double *values, int rows,
+                               const double *x, double *y)
+{
+    for (int r = 0; r < rows; ++r) {
+        double sum = 0.0;
+        for (int j = rowStart[r]; j < rowStart[r + 1]; ++j) {
+            sum += values[j] * x[columns[j]];
+        }
+        y[r] = sum;
+    }
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+ANALYSIS_TARGET_AVX2
+static void sparseMatVecAVX2(const int *rowStart, const int *columns, const double *values, int rows,
+                             const double *x, double *y)
+{
+    for (int r = 0; r < rows; ++r) {
+        const int end = rowStart[r + 1];
+
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+
+        int j = rowStart[r];
+        for (; j + 8 <= end; j += 8) {
+            const __m128i idx0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(columns + j));
+            const __m128i idx1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(columns + j + 4));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(values + j),     _mm256_i32gather_pd(x, idx0, 8), acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(values + j + 4), _mm256_i32gather_pd(x, idx1, 8), acc1);
+        }
+        for (; j + 4 <= end; j += 4) {
+            const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(columns + j));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(values + j), _mm256_i32gather_pd(x, idx, 8), acc0);
+        }
+
+        const __m256d acc = _mm256_add_pd(acc0, acc1);
+        const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+
+        for (; j < end; ++j) {
+            sum += values[j] * x[columns[j]];
+        }
+        y[r] = sum;
+    }
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static void sparseMatVecNEON(const int *rowStart, const int *columns, const double *values, int rows,
+                             const double *x, double *y)
+{
+    for (int r = 0; r < rows; ++r) {
+        const int end = rowStart[r + 1];
+
+        float64x2_t acc0 = vdupq_n_f64(0.0);
+        float64x2_t acc1 = vdupq_n_f64(0.0);
+
+        // NEON has no gather, so pairs are assembled from scalar loads.
+        int j = rowStart[r];
+        for (; j + 4 <= end; j += 4) {
+            const float64x2_t x0 = vsetq_lane_f64(x[columns[j + 1]], vdupq_n_f64(x[columns[j]]), 1);
+            const float64x2_t x1 = vsetq_lane_f64(x[columns[j + 3]], vdupq_n_f64(x[columns[j + 2]]), 1);
+            acc0 = vfmaq_f64(acc0, vld1q_f64(values + j),     x0);
+            acc1 = vfmaq_f64(acc1, vld1q_f64(values + j + 2), x1);
+        }
+
+        double sum = vaddvq_f64(vaddq_f64(acc0, acc1));
+
+        for (; j < end; ++j) {
+            sum += values[j] * x[columns[j]];
+        }
+        y[r] = sum;
+    }
+}
+
+#endif
+
+using SparseMatVecKernel = void (*)(const int *, const int *, const double *, int, const double *, double *);
+
+static SparseMatVecKernel selectSparseMatVecKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return sparseMatVecAVX2;
+    }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return sparseMatVecNEON;
+#endif
+    return sparseMatVecScalar;
+}
+
+void Analysis::SIMD::sparseMatVec(const int *rowStart, const int *columns, const double *values, int rows,
+                                  const double *x, double *y)
+{
+    static const SparseMatVecKernel kernel = selectSparseMatVecKernel();
+    kernel(rowStart, columns, values, rows, x, y);
+}
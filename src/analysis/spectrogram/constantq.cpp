@@ -0,0 +1,137 @@
+#include "spectrogram.h"
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+
+using namespace Analysis::Spectrogram;
+
+// Spectral kernel coefficients below this fraction of their kernel's peak are dropped.
+static constexpr double kernelThreshold = 0.0054;
+
+static inline int pow2roundup(int x)
+{
+    int y = 1;
+    while (y < x)
+        y <<= 1;
+    return y;
+}
+
+ConstantQ::ConstantQ(double minFrequency, int binsPerOctave)
+    : mMinFrequency(minFrequency),
+      mBinsPerOctave(binsPerOctave),
+      mSampleRate(0.0),
+      mFrameLength(0),
+      mBinCount(0)
+{
+}
+
+void ConstantQ::compute(const double *frame, int n, double sampleRate, int hop, rpm::vector<double>& power)
+{
+    if (!mFFT || mFrameLength != n || mSampleRate != sampleRate) {
+        makeKernels(n, sampleRate);
+        mSampleRate = sampleRate;
+        mFrameLength = n;
+        std::fill(mHistory.begin(), mHistory.end(), 0.0);
+    }
+
+    // The whole frame is copied in after the shift, so that a gap in the calls only leaves
+    // stale samples beyond the frame.
+    const int length = (int) mHistory.size();
+    hop = std::clamp(hop, 0, n);
+    std::rotate(mHistory.begin(), std::next(mHistory.begin(), hop), mHistory.end());
+    std::copy(frame, frame + n, std::prev(mHistory.end(), n));
+
+    mFFT->fillInput(mHistory.data(), length);
+    mFFT->computeForward();
+
+    // The kernels act on the real and imaginary parts of the spectrum as interleaved doubles.
+    const double *spectrum = reinterpret_cast<const double *>(mFFT->outputView().data());
+    mKernels->apply(spectrum, mProducts.data());
+
+    power.resize(mBinCount);
+    for (int b = 0; b < mBinCount; ++b) {
+        const double re = mProducts[2 * b];
+        const double im = mProducts[2 * b + 1];
+        power[b] = re * re + im * im;
+    }
+}
+
+Analysis::SpectrogramAxis ConstantQ::getAxis() const
+{
+    const int last = std::max(mBinCount - 1, 0);
+    return { true, mMinFrequency, mMinFrequency * pow(2.0, (double) last / mBinsPerOctave) };
+}
+
+double ConstantQ::getCentreOffset(int n) const
+{
+    return mHistory.empty() ? n / 2.0 : mHistory.size() / 2.0;
+}
+
+// Bin b is (1 / N) sum over k of X[k] conj(K_b[k]), where K_b is the transform of a Hann
+// windowed complex exponential at the bin's frequency, centred in the history and normalised
+// by its length. The history holds the frame or the lowest bin's kernel, whichever is longer,
+// zero-padded to N. Only the positive frequencies count, since the kernels have almost no
+// energy at negative ones.
+void ConstantQ::makeKernels(int n, double sampleRate)
+{
+    const double Q = 1.0 / (pow(2.0, 1.0 / mBinsPerOctave) - 1.0);
+
+    // Bins stop before their bandwidth would cross the Nyquist frequency.
+    int count = 0;
+    while (mMinFrequency * pow(2.0, (double) count / mBinsPerOctave) * (1.0 + 0.5 / Q) < sampleRate / 2.0) {
+        count++;
+    }
+    if (count == 0) {
+        throw std::runtime_error("Spectrogram::ConstantQ] Minimum frequency above the Nyquist frequency");
+    }
+
+    const int history = std::max(n, (int) ceil(Q * sampleRate / mMinFrequency));
+    const int N = pow2roundup(history);
+    const int m = N / 2 + 1;
+
+    ComplexFFT fft(N);
+    rpm::vector<std::dcomplex> temporal(N);
+    std::vector<Eigen::Triplet<double>> triplets;
+
+    for (int b = 0; b < count; ++b) {
+        const double frequency = mMinFrequency * pow(2.0, (double) b / mBinsPerOctave);
+        const int length = std::min(history, (int) ceil(Q * sampleRate / frequency));
+        const int start = (history - length) / 2;
+
+        std::fill(temporal.begin(), temporal.end(), 0.0);
+        for (int i = 0; i < length; ++i) {
+            const double w = (0.5 - 0.5 * cos((2.0 * M_PI * i) / length)) / length;
+            temporal[start + i] = std::polar(w, (2.0 * M_PI * frequency * i) / sampleRate);
+        }
+
+        fft.fillData(temporal.data(), N);
+        fft.computeForward();
+        const auto kernel = fft.dataView();
+
+        double peak = 0.0;
+        for (int k = 0; k < m; ++k) {
+            peak = std::max(peak, std::abs(kernel[k]));
+        }
+
+        // Re = Kr Xr + Ki Xi, Im = Kr Xi - Ki Xr.
+        for (int k = 0; k < m; ++k) {
+            if (std::abs(kernel[k]) < kernelThreshold * peak)
+                continue;
+            const double kr = kernel[k].real() / N;
+            const double ki = kernel[k].imag() / N;
+            triplets.emplace_back(2 * b, 2 * k, kr);
+            triplets.emplace_back(2 * b, 2 * k + 1, ki);
+            triplets.emplace_back(2 * b + 1, 2 * k + 1, kr);
+            triplets.emplace_back(2 * b + 1, 2 * k, -ki);
+        }
+    }
+
+    Eigen::SparseMatrix<double> kernels(2 * count, 2 * m);
+    kernels.setFromTriplets(triplets.begin(), triplets.end());
+
+    mFFT = std::make_unique<RealFFT>(N);
+    mHistory.resize(history);
+    mKernels = std::make_unique<CSRFilterbank>(kernels);
+    mProducts.resize(2 * count);
+    mBinCount = count;
+}
@@ -0,0 +1,160 @@
+#include "spectrogram.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+
+// Solves (T - shift I) x = b in place, for the symmetric tridiagonal T with diagonal d
+// and off-diagonal e, by Gaussian elimination with partial pivoting.
+static void solveShiftedTridiagonal(const Eigen::VectorXd& d, const Eigen::VectorXd& e, double shift,
+        double *b, rpm::vector<double>& work)
+{
+    const int n = (int) d.size();
+
+    work.resize(3 * n);
+    double *dd = work.data();
+    double *du = dd + n;
+    double *dl = du + n;
+
+    for (int i = 0; i < n; ++i) {
+        dd[i] = d(i) - shift;
+    }
+    for (int i = 0; i < n - 1; ++i) {
+        du[i] = e(i);
+        dl[i] = e(i);
+    }
+
+    // A zero pivot only means that the shift is an exact eigenvalue.
+    const double tiny = 1e-300;
+
+    for (int i = 0; i < n - 1; ++i) {
+        if (std::abs(dd[i]) >= std::abs(dl[i])) {
+            if (dd[i] == 0.0)
+                dd[i] = tiny;
+            const double fact = dl[i] / dd[i];
+            dd[i + 1] -= fact * du[i];
+            b[i + 1] -= fact * b[i];
+            dl[i] = 0.0;
+        }
+        else {
+            const double fact = dd[i] / dl[i];
+            dd[i] = dl[i];
+            const double temp = dd[i + 1];
+            dd[i + 1] = du[i] - fact * temp;
+            if (i < n - 2) {
+                dl[i] = du[i + 1];
+                du[i + 1] = -fact * dl[i];
+            }
+            du[i] = temp;
+            const double tb = b[i];
+            b[i] = b[i + 1];
+            b[i + 1] = tb - fact * b[i + 1];
+        }
+    }
+    if (dd[n - 1] == 0.0)
+        dd[n - 1] = tiny;
+
+    // dl now holds the second superdiagonal of U.
+    b[n - 1] /= dd[n - 1];
+    if (n > 1)
+        b[n - 2] = (b[n - 2] - du[n - 2] * b[n - 1]) / dd[n - 2];
+    for (int i = n - 3; i >= 0; --i) {
+        b[i] = (b[i] - du[i] * b[i + 1] - dl[i] * b[i + 2]) / dd[i];
+    }
+}
+
+// Number of eigenvalues of the symmetric tridiagonal T below x, from the signs of the
+// pivots of T - x I (Sturm sequence).
+static int countEigenvaluesBelow(const Eigen::VectorXd& d, const Eigen::VectorXd& e, double x)
+{
+    const int n = (int) d.size();
+
+    int count = 0;
+    double q = d(0) - x;
+    for (int i = 0; ; ++i) {
+        if (q < 0.0)
+            count++;
+        if (i == n - 1)
+            break;
+        if (q == 0.0)
+            q = 1e-300;
+        q = (d(i + 1) - x) - e(i) * e(i) / q;
+    }
+    return count;
+}
+
+// The tapers are the eigenvectors of the tridiagonal matrix commuting with the
+// time-frequency concentration problem, for its largest eigenvalues. Only those
+// eigenvalues are located, by Sturm bisection, and each vector takes a few inverse
+// iterations, so the cost stays linear in n per taper.
+void Analysis::dpss(int n, double nw, int count, double *tapers)
+{
+    if (n < 2 || count < 1 || count > n) {
+        throw std::runtime_error("Spectrogram::dpss] Invalid taper length or count");
+    }
+
+    const double w = nw / n;
+    const double c = cos(2.0 * M_PI * w);
+
+    Eigen::VectorXd d(n);
+    Eigen::VectorXd e(n - 1);
+    for (int i = 0; i < n; ++i) {
+        const double t = (n - 1 - 2.0 * i) / 2.0;
+        d(i) = t * t * c;
+    }
+    for (int i = 1; i < n; ++i) {
+        e(i - 1) = i * (n - i) / 2.0;
+    }
+
+    // Gershgorin bounds on the spectrum.
+    double lower = HUGE_VAL, upper = -HUGE_VAL;
+    for (int i = 0; i < n; ++i) {
+        const double r = (i > 0 ? std::abs(e(i - 1)) : 0.0) + (i < n - 1 ? std::abs(e(i)) : 0.0);
+        lower = std::min(lower, d(i) - r);
+        upper = std::max(upper, d(i) + r);
+    }
+
+    rpm::vector<double> work;
+
+    for (int k = 0; k < count; ++k) {
+        // Bisect for the eigenvalue with n - 1 - k others below it.
+        const int index = n - 1 - k;
+        double lo = lower, hi = upper;
+        while (hi - lo > 1e-15 * std::max(std::abs(lo), std::abs(hi))) {
+            const double mid = 0.5 * (lo + hi);
+            if (mid <= lo || mid >= hi)
+                break;
+            if (countEigenvaluesBelow(d, e, mid) > index)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        const double lambda = 0.5 * (lo + hi);
+        double *v = tapers + k * n;
+
+        // Any start vector that isn't orthogonal to the taper will do.
+        for (int i = 0; i < n; ++i) {
+            v[i] = 1.0 + 0.5 * sin(0.7 * i + 0.3 * k);
+        }
+
+        for (int iter = 0; iter < 3; ++iter) {
+            solveShiftedTridiagonal(d, e, lambda, v, work);
+
+            double norm = 0.0;
+            for (int i = 0; i < n; ++i)
+                norm += v[i] * v[i];
+            norm = 1.0 / sqrt(norm);
+            for (int i = 0; i < n; ++i)
+                v[i] *= norm;
+        }
+
+        // Symmetric tapers have a positive mean, antisymmetric ones start with a positive lobe.
+        double sign = 0.0;
+        for (int i = 0; i < n; ++i) {
+            sign += (k % 2 == 0) ? v[i] : ((n - 1) / 2.0 - i) * v[i];
+        }
+        if (sign < 0.0) {
+            for (int i = 0; i < n; ++i)
+                v[i] = -v[i];
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#include "spectrogram.h"
+#include "../simd/simd.h"
+#include <Eigen/Core>
+
+using namespace Analysis::Spectrogram;
+using namespace Eigen;
+
+Multitaper::Multitaper(double nw, int taperCount)
+    : mNW(nw),
+      mTaperCount(taperCount)
+{
+}
+
+void Multitaper::compute(const double *frame, int n, double, int, rpm::vector<double>& power)
+{
+    if (!mFFT || mFFT->getInputLength() != n) {
+        mFFT = std::make_unique<RealFFTBatch>(n, mTaperCount);
+        mTapers.resize(mTaperCount * n);
+        dpss(n, mNW, mTaperCount, mTapers.data());
+    }
+
+    for (int t = 0; t < mTaperCount; ++t) {
+        SIMD::multiply(frame, &mTapers[t * n], mFFT->input(t), n);
+    }
+
+    mFFT->computeForward();
+
+    const int m = mFFT->getOutputLength();
+
+    power.resize(m);
+    Map<ArrayXd> p(power.data(), m);
+
+    p = Map<const ArrayXcd>(mFFT->output(0), m).abs2();
+    for (int t = 1; t < mTaperCount; ++t) {
+        p += Map<const ArrayXcd>(mFFT->output(t), m).abs2();
+    }
+    p /= (double) mTaperCount;
+}
@@ -0,0 +1,71 @@
+#include "spectrogram.h"
+#include "../simd/simd.h"
+#include "../window/window.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+
+using namespace Analysis::Spectrogram;
+using namespace Eigen;
+
+void Reassigned::compute(const double *frame, int n, double, int hop, rpm::vector<double>& power)
+{
+    const auto window = getWindow(WindowType::BlackmanHarris, n);
+
+    if (!mFFT || mFFT->getInputLength() != n) {
+        mFFT = std::make_unique<RealFFTBatch>(n, 3);
+
+        // t h(t) with t counted from the frame centre, and dh/dt of the Blackman-Harris window.
+        constexpr double a1 = 0.48829;
+        constexpr double a2 = 0.14128;
+        constexpr double a3 = 0.01168;
+        const double centre = (n - 1) / 2.0;
+        const double step = 2.0 * M_PI / (n - 1);
+
+        mTimeWindow.resize(n);
+        mDerivativeWindow.resize(n);
+        for (int j = 0; j < n; ++j) {
+            const double theta = step * j;
+            mTimeWindow[j] = (j - centre) * window[j];
+            mDerivativeWindow[j] = step * (a1 * sin(theta) - 2 * a2 * sin(2 * theta) + 3 * a3 * sin(3 * theta));
+        }
+    }
+
+    applyWindow(frame, window, mFFT->input(0));
+    SIMD::multiply(frame, mTimeWindow.data(), mFFT->input(1), n);
+    SIMD::multiply(frame, mDerivativeWindow.data(), mFFT->input(2), n);
+
+    mFFT->computeForward();
+
+    const int m = mFFT->getOutputLength();
+
+    const Map<const ArrayXcd> Xh(mFFT->output(0), m);
+    const Map<const ArrayXcd> Xth(mFFT->output(1), m);
+    const Map<const ArrayXcd> Xdh(mFFT->output(2), m);
+
+    // Instantaneous frequency k - n / 2pi Im(Xdh / Xh) in bins, and group delay Re(Xth / Xh) in samples,
+    // for every bin with non-negligible energy.
+    const ArrayXd energy = Xh.abs2();
+    const double floor = 1e-14 * energy.maxCoeff();
+    const ArrayXd inverse = (energy > floor).select(energy.inverse(), 0.0);
+
+    const ArrayXd frequency = ArrayXd::LinSpaced(m, 0, m - 1)
+                                - n / (2.0 * M_PI) * (Xdh * Xh.conjugate()).imag() * inverse;
+    const ArrayXd delay = (Xth * Xh.conjugate()).real() * inverse;
+
+    const double maxDelay = std::max(0.5 * hop, 0.5);
+
+    power.assign(m, 0.0);
+    for (int k = 0; k < m; ++k) {
+        const double f = frequency(k);
+        if (inverse(k) == 0.0 || std::abs(delay(k)) > maxDelay || !(f >= 0.0 && f <= m - 1)) {
+            continue;
+        }
+
+        // Split between the two nearest bins.
+        const int k0 = std::min((int) f, m - 2);
+        const double frac = f - k0;
+        power[k0] += (1.0 - frac) * energy(k);
+        power[k0 + 1] += frac * energy(k);
+    }
+}
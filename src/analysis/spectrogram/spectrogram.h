@@ -0,0 +1,117 @@
+#ifndef ANALYSIS_SPECTROGRAM_H
+#define ANALYSIS_SPECTROGRAM_H
+
+#include "rpcxx.h"
+#include <memory>
+
+#include "../fft/fft.h"
+#include "../filterbanks/filterbanks.h"
+
+namespace Analysis {
+
+    // Frequency axis of an engine's output: n / 2 + 1 bins evenly spaced up to the Nyquist
+    // frequency, or bins spaced geometrically from minFrequency to maxFrequency.
+    struct SpectrogramAxis {
+        bool logarithmic;
+        double minFrequency;
+        double maxFrequency;
+    };
+
+    class SpectrogramEngine {
+    public:
+        virtual ~SpectrogramEngine() {}
+
+        // Power spectrum of an n-sample frame, on the axis given by getAxis. hop is the number
+        // of samples by which the frame moved since the previous call.
+        virtual void compute(const double *frame, int n, double sampleRate, int hop, rpm::vector<double>& power) = 0;
+
+        virtual SpectrogramAxis getAxis() const { return { false, 0.0, 0.0 }; }
+
+        // Samples from the centre of what the last call analysed to the end of its n-sample frame.
+        virtual double getCentreOffset(int n) const { return n / 2.0; }
+
+        // Transforms shared with the other consumers of the pipeline. Engines keep their own otherwise.
+        void setSpectralFrames(SpectralFrames *frames) { mSharedFrames = frames; }
+
+    protected:
+        // Without a pipeline to mark the hops, every call starts one.
+        SpectralFrames& spectralFrames()
+        {
+            if (mSharedFrames != nullptr) {
+                return *mSharedFrames;
+            }
+            mOwnFrames.nextHop();
+            return mOwnFrames;
+        }
+
+    private:
+        SpectralFrames *mSharedFrames = nullptr;
+        SpectralFrames mOwnFrames;
+    };
+
+    namespace Spectrogram {
+        // Blackman-Harris windowed periodogram.
+        class Standard : public SpectrogramEngine {
+        public:
+            void compute(const double *frame, int n, double sampleRate, int hop, rpm::vector<double>& power) override;
+        };
+
+        // Reassigned spectrogram: the window, time-weighted window and window derivative
+        // transforms, run as one batch, move each bin's energy to its instantaneous frequency.
+        // Bins whose group delay falls more than half a hop from the frame centre are left
+        // to the neighbouring frames.
+        class Reassigned : public SpectrogramEngine {
+        public:
+            void compute(const double *frame, int n, double sampleRate, int hop, rpm::vector<double>& power) override;
+        private:
+            std::unique_ptr<RealFFTBatch> mFFT;
+            rpm::vector<double> mTimeWindow;
+            rpm::vector<double> mDerivativeWindow;
+        };
+
+        // Average of the periodograms of the first taperCount DPSS tapers with time-bandwidth
+        // product nw, run as one batch.
+        class Multitaper : public SpectrogramEngine {
+        public:
+            Multitaper(double nw = 4.0, int taperCount = 7);
+            void compute(const double *frame, int n, double sampleRate, int hop, rpm::vector<double>& power) override;
+        private:
+            double mNW;
+            int mTaperCount;
+            std::unique_ptr<RealFFTBatch> mFFT;
+            rpm::vector<double> mTapers;
+        };
+
+        // Constant-Q spectrogram after Brown and Puckette: every bin is the product of the input's
+        // spectrum with a sparse spectral kernel, all precomputed per frame length and rate and
+        // applied as one CSR product. Bins start at minFrequency, binsPerOctave to an octave.
+        // The input is a history of the hops long enough for the lowest bin's full kernel, so
+        // the columns lag the frame by half of that.
+        class ConstantQ : public SpectrogramEngine {
+        public:
+            ConstantQ(double minFrequency = 55.0, int binsPerOctave = 24);
+            void compute(const double *frame, int n, double sampleRate, int hop, rpm::vector<double>& power) override;
+            SpectrogramAxis getAxis() const override;
+            double getCentreOffset(int n) const override;
+        private:
+            void makeKernels(int n, double sampleRate);
+
+            double mMinFrequency;
+            int mBinsPerOctave;
+            double mSampleRate;
+            int mFrameLength;
+            int mBinCount;
+            rpm::vector<double> mHistory;
+            std::unique_ptr<RealFFT> mFFT;
+            std::unique_ptr<CSRFilterbank> mKernels;
+            rpm::vector<double> mProducts;
+        };
+    }
+
+    // First count discrete prolate spheroidal sequences of length n and time-bandwidth
+    // product nw, with unit energy, written one after the other to tapers.
+    void dpss(int n, double nw, int count, double *tapers);
+
+}
+
+#endif // ANALYSIS_SPECTROGRAM_H
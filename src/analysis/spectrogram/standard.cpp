@@ -0,0 +1,10 @@
+#include "spectrogram.h"
+
+using namespace Analysis::Spectrogram;
+
+void Standard::compute(const double *frame, int n, double sampleRate, int, rpm::vector<double>& power)
+{
+    // Within a hop, the transform is shared with any other consumer of the same rate, size and window.
+    auto& spectralFrame = spectralFrames().get(sampleRate, n, SpectralWindow::BlackmanHarris, frame, n);
+    power = spectralFrame.powerSpectrum();
+}
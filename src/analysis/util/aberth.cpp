@@ -1,6 +1,12 @@
 #include "util.h"
 #include "aberth.h"
+#include "../simd/simd.h"
+#include <algorithm>
 #include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 static std::random_device rd;
 #if CMAKE_SIZE_OF_VOID_P == 4
@@ -9,6 +15,25 @@ static std::mt19937 gen(rd());
 static std::mt19937_64 gen(rd());
 #endif
 
+// The project builds with -ffast-math, under which std::isfinite may fold to true,
+// so the exponent bits are tested directly.
+static bool isFiniteBits(double x)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return ((bits >> 52) & 0x7ff) != 0x7ff;
+}
+
+static bool allRootsFinite(const rpm::vector<std::complex<double>>& roots)
+{
+    for (const auto& z : roots) {
+        if (!isFiniteBits(z.real()) || !isFiniteBits(z.imag())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static std::pair<double, double> upperLowerBounds(const rpm::vector<double>& P)
 {
     const int degree = static_cast<int>(P.size()) - 1;
@@ -29,186 +54,489 @@ static std::pair<double, double> upperLowerBounds(const rpm::vector<double>& P)
     return { upper, lower };
 }
 
-static rpm::vector<std::complex<double>> initRoots(const rpm::vector<double>& P)
+template<typename Engine>
+static void initRoots(const rpm::vector<double>& P, Engine& engine, rpm::vector<std::complex<double>>& roots)
 {
     const int degree = static_cast<int>(P.size()) - 1;
     const auto [upper, lower] = upperLowerBounds(P);
 
-    static std::uniform_real_distribution<> radius(lower, upper);
-    static std::uniform_real_distribution<> angle(0, 2 * M_PI);
+    std::uniform_real_distribution<> radius(lower, upper);
+    std::uniform_real_distribution<> angle(0, 2 * M_PI);
 
-    rpm::vector<std::complex<double>> roots;
+    roots.resize(degree);
     for (int i = 0; i < degree; ++i) {
-        roots.push_back(std::polar(radius(gen), angle(gen)));
+        roots[i] = std::polar(radius(engine), angle(engine));
     }
-    return roots;
 }
 
-static rpm::vector<std::complex<double>> evaluatePolyDer(const rpm::vector<double>& P, const std::complex<double>& x, int numberOfDerivatives)
+// The iteration works on all roots at once in SoA layout: one pass evaluates
+// P and P' at every root, a second forms every pairwise reciprocal sum, and
+// the corrections are then applied together (total-step Aberth).
+
+static void evaluatePolyDerScalar(const double *P, int degree, const double *re, const double *im, int n,
+                                  double *pRe, double *pIm, double *dRe, double *dIm)
 {
-    const int degree = static_cast<int>(P.size()) - 1;
-    rpm::vector<std::complex<double>> derivatives(numberOfDerivatives + 1);
-    numberOfDerivatives = numberOfDerivatives > degree ? degree : numberOfDerivatives;
+    for (int k = 0; k < n; ++k) {
+        const double zr = re[k];
+        const double zi = im[k];
+
+        double pr = P[0], pi = 0.0;
+        double dr = 0.0, di = 0.0;
+
+        for (int i = 1; i <= degree; ++i) {
+            const double ndr = dr * zr - di * zi + pr;
+            const double ndi = dr * zi + di * zr + pi;
+            const double npr = pr * zr - pi * zi + P[i];
+            const double npi = pr * zi + pi * zr;
+            dr = ndr; di = ndi;
+            pr = npr; pi = npi;
+        }
+
+        pRe[k] = pr; pIm[k] = pi;
+        dRe[k] = dr; dIm[k] = di;
+    }
+}
+
+// Sums for the roots from first on, against all n roots. The SIMD kernels finish with it.
+static void reciprocalSumsFrom(const double *re, const double *im, int n, int first, double *sRe, double *sIm)
+{
+    for (int k = first; k < n; ++k) {
+        double sr = 0.0, si = 0.0;
+        for (int j = 0; j < n; ++j) {
+            if (j != k) {
+                const double dr = re[k] - re[j];
+                const double di = im[k] - im[j];
+                const double inv = 1.0 / (dr * dr + di * di);
+                sr += dr * inv;
+                si -= di * inv;
+            }
+        }
+        sRe[k] = sr;
+        sIm[k] = si;
+    }
+}
+
+static void reciprocalSumsScalar(const double *re, const double *im, int n, double *sRe, double *sIm)
+{
+    reciprocalSumsFrom(re, im, n, 0, sRe, sIm);
+}
+
+#if defined(ANALYSIS_SIMD_AVX2)
+
+ANALYSIS_TARGET_AVX2
+static void evaluatePolyDerAVX2(const double *P, int degree, const double *re, const double *im, int n,
+                                double *pRe, double *pIm, double *dRe, double *dIm)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        const __m256d zr = _mm256_loadu_pd(re + k);
+        const __m256d zi = _mm256_loadu_pd(im + k);
+
+        __m256d pr = _mm256_set1_pd(P[0]), pi = _mm256_setzero_pd();
+        __m256d dr = _mm256_setzero_pd(), di = _mm256_setzero_pd();
+
+        for (int i = 1; i <= degree; ++i) {
+            const __m256d ndr = _mm256_add_pd(_mm256_fmsub_pd(dr, zr, _mm256_mul_pd(di, zi)), pr);
+            const __m256d ndi = _mm256_add_pd(_mm256_fmadd_pd(dr, zi, _mm256_mul_pd(di, zr)), pi);
+            const __m256d npr = _mm256_add_pd(_mm256_fmsub_pd(pr, zr, _mm256_mul_pd(pi, zi)), _mm256_set1_pd(P[i]));
+            const __m256d npi = _mm256_fmadd_pd(pr, zi, _mm256_mul_pd(pi, zr));
+            dr = ndr; di = ndi;
+            pr = npr; pi = npi;
+        }
+
+        _mm256_storeu_pd(pRe + k, pr);
+        _mm256_storeu_pd(pIm + k, pi);
+        _mm256_storeu_pd(dRe + k, dr);
+        _mm256_storeu_pd(dIm + k, di);
+    }
+
+    evaluatePolyDerScalar(P, degree, re + k, im + k, n - k, pRe + k, pIm + k, dRe + k, dIm + k);
+}
+
+ANALYSIS_TARGET_AVX2
+static void reciprocalSumsAVX2(const double *re, const double *im, int n, double *sRe, double *sIm)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        const __m256d zr = _mm256_loadu_pd(re + k);
+        const __m256d zi = _mm256_loadu_pd(im + k);
+        const __m256d lanes = _mm256_setr_pd(k, k + 1, k + 2, k + 3);
 
-    derivatives[0] = P[0];
+        __m256d sr = _mm256_setzero_pd();
+        __m256d si = _mm256_setzero_pd();
 
-    for (int i = 1; i <= degree; ++i) {
-        const int n = numberOfDerivatives < i ? numberOfDerivatives : i;
-        for (int j = n; j >= 1; --j) {
-            derivatives[j] = derivatives[j] * x + derivatives[j - 1];
+        for (int j = 0; j < n; ++j) {
+            const __m256d dr = _mm256_sub_pd(zr, _mm256_set1_pd(re[j]));
+            const __m256d di = _mm256_sub_pd(zi, _mm256_set1_pd(im[j]));
+            const __m256d inv = _mm256_div_pd(one, _mm256_fmadd_pd(dr, dr, _mm256_mul_pd(di, di)));
+
+            // Drop the j == k term, which would be 0/0.
+            const __m256d keep = _mm256_cmp_pd(lanes, _mm256_set1_pd(j), _CMP_NEQ_OQ);
+
+            sr = _mm256_add_pd(sr, _mm256_and_pd(keep, _mm256_mul_pd(dr, inv)));
+            si = _mm256_sub_pd(si, _mm256_and_pd(keep, _mm256_mul_pd(di, inv)));
+        }
+
+        _mm256_storeu_pd(sRe + k, sr);
+        _mm256_storeu_pd(sIm + k, si);
+    }
+
+    reciprocalSumsFrom(re, im, n, k, sRe, sIm);
+}
+
+#elif defined(ANALYSIS_SIMD_NEON)
+
+static void evaluatePolyDerNEON(const double *P, int degree, const double *re, const double *im, int n,
+                                double *pRe, double *pIm, double *dRe, double *dIm)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        const float64x2_t zr = vld1q_f64(re + k);
+        const float64x2_t zi = vld1q_f64(im + k);
+
+        float64x2_t pr = vdupq_n_f64(P[0]), pi = vdupq_n_f64(0.0);
+        float64x2_t dr = vdupq_n_f64(0.0), di = vdupq_n_f64(0.0);
+
+        for (int i = 1; i <= degree; ++i) {
+            const float64x2_t ndr = vaddq_f64(vfmsq_f64(vmulq_f64(dr, zr), di, zi), pr);
+            const float64x2_t ndi = vaddq_f64(vfmaq_f64(vmulq_f64(dr, zi), di, zr), pi);
+            const float64x2_t npr = vaddq_f64(vfmsq_f64(vmulq_f64(pr, zr), pi, zi), vdupq_n_f64(P[i]));
+            const float64x2_t npi = vfmaq_f64(vmulq_f64(pr, zi), pi, zr);
+            dr = ndr; di = ndi;
+            pr = npr; pi = npi;
+        }
+
+        vst1q_f64(pRe + k, pr);
+        vst1q_f64(pIm + k, pi);
+        vst1q_f64(dRe + k, dr);
+        vst1q_f64(dIm + k, di);
+    }
+
+    evaluatePolyDerScalar(P, degree, re + k, im + k, n - k, pRe + k, pIm + k, dRe + k, dIm + k);
+}
+
+static void reciprocalSumsNEON(const double *re, const double *im, int n, double *sRe, double *sIm)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        const float64x2_t zr = vld1q_f64(re + k);
+        const float64x2_t zi = vld1q_f64(im + k);
+        const float64x2_t lanes = { (double) k, (double) (k + 1) };
+
+        float64x2_t sr = vdupq_n_f64(0.0);
+        float64x2_t si = vdupq_n_f64(0.0);
+
+        for (int j = 0; j < n; ++j) {
+            const float64x2_t dr = vsubq_f64(zr, vdupq_n_f64(re[j]));
+            const float64x2_t di = vsubq_f64(zi, vdupq_n_f64(im[j]));
+            const float64x2_t inv = vdivq_f64(vdupq_n_f64(1.0), vfmaq_f64(vmulq_f64(dr, dr), di, di));
+
+            // Drop the j == k term, which would be 0/0.
+            const uint64x2_t skip = vceqq_f64(lanes, vdupq_n_f64(j));
+
+            sr = vaddq_f64(sr, vreinterpretq_f64_u64(vbicq_u64(vreinterpretq_u64_f64(vmulq_f64(dr, inv)), skip)));
+            si = vsubq_f64(si, vreinterpretq_f64_u64(vbicq_u64(vreinterpretq_u64_f64(vmulq_f64(di, inv)), skip)));
         }
-        derivatives[0] = derivatives[0] * x + P[i];
+
+        vst1q_f64(sRe + k, sr);
+        vst1q_f64(sIm + k, si);
+    }
+
+    reciprocalSumsFrom(re, im, n, k, sRe, sIm);
+}
+
+#endif
+
+using EvaluatePolyDerKernel = void (*)(const double *, int, const double *, const double *, int, double *, double *, double *, double *);
+using ReciprocalSumsKernel = void (*)(const double *, const double *, int, double *, double *);
+
+static EvaluatePolyDerKernel selectEvaluatePolyDerKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return evaluatePolyDerAVX2;
     }
+#elif defined(ANALYSIS_SIMD_NEON)
+    return evaluatePolyDerNEON;
+#endif
+    return evaluatePolyDerScalar;
+}
 
-    double fact = 1.0;
-    for (int j = 2; j <= numberOfDerivatives; ++j) {
-        fact *= j;
-        derivatives[j] *= fact;
+static ReciprocalSumsKernel selectReciprocalSumsKernel()
+{
+#if defined(ANALYSIS_SIMD_AVX2)
+    if (Analysis::SIMD::hasAVX2()) {
+        return reciprocalSumsAVX2;
     }
-    return derivatives;
+#elif defined(ANALYSIS_SIMD_NEON)
+    return reciprocalSumsNEON;
+#endif
+    return reciprocalSumsScalar;
 }
 
-static void aberthIterate(const rpm::vector<double>& P, rpm::vector<std::complex<double>>& roots)
+static bool aberthIterate(const rpm::vector<double>& P, rpm::vector<std::complex<double>>& roots, int maxIterations, double tolerance, int *pIterations, rpm::vector<double>& work)
 {
+    static const EvaluatePolyDerKernel evaluatePolyDer = selectEvaluatePolyDerKernel();
+    static const ReciprocalSumsKernel reciprocalSums = selectReciprocalSumsKernel();
+
+    const int degree = static_cast<int>(P.size()) - 1;
+    const int n = (int) roots.size();
+
+    work.resize(8 * n);
+    double *re  = work.data();
+    double *im  = re + n;
+    double *pRe = im + n;
+    double *pIm = pRe + n;
+    double *dRe = pIm + n;
+    double *dIm = dRe + n;
+    double *sRe = dIm + n;
+    double *sIm = sRe + n;
+
+    for (int k = 0; k < n; ++k) {
+        re[k] = roots[k].real();
+        im[k] = roots[k].imag();
+    }
+
     int iteration = 0;
-    
-    while (true) {
+    bool converged = false;
+
+    while (!converged && iteration < maxIterations) {
+        evaluatePolyDer(P.data(), degree, re, im, n, pRe, pIm, dRe, dIm);
+        reciprocalSums(re, im, n, sRe, sIm);
+
         int valid = 0;
-        for (int k = 0; k < (int) roots.size(); ++k) {
-            auto y = evaluatePolyDer(P, roots[k], 1);
-            auto ratio = y[0] / y[1];
-
-            std::complex<double> sum = 0.0;
-            for (int j = 0; j < (int) roots.size(); ++j) {
-                if (j != k) {
-                    sum += 1.0 / (roots[k] - roots[j]);
-                }
-            }
+        for (int k = 0; k < n; ++k) {
+            const std::complex<double> ratio = std::complex<double>(pRe[k], pIm[k]) / std::complex<double>(dRe[k], dIm[k]);
+            const std::complex<double> offset = ratio / (1.0 - ratio * std::complex<double>(sRe[k], sIm[k]));
 
-            auto offset = ratio / (1.0 - ratio * sum);
-            if (std::abs(offset.real()) < 1e-10 && std::abs(offset.imag()) < 1e-10) {
+            if (std::abs(offset.real()) < tolerance && std::abs(offset.imag()) < tolerance) {
                 valid++;
             }
-            roots[k] -= offset;
-        }
-        if (valid == (int) roots.size()) {
-            break;
+            re[k] -= offset.real();
+            im[k] -= offset.imag();
         }
         iteration++;
+
+        if (valid == n) {
+            converged = true;
+        }
+    }
+
+    if (pIterations != nullptr) {
+        *pIterations += iteration;
+    }
+
+    for (int k = 0; k < n; ++k) {
+        roots[k] = { re[k], im[k] };
     }
+
+    if (!allRootsFinite(roots)) {
+        return false;
+    }
+
+    return converged;
 }
 
+static constexpr int kMaxIterations = 100;
+static constexpr double kTolerance = 1e-10;
+
 rpm::vector<std::complex<double>> Analysis::aberthRoots(
         const rpm::vector<double>& P)
 {
-    auto roots = initRoots(P);
-    
-    aberthIterate(P, roots);
+    rpm::vector<std::complex<double>> roots;
+    rpm::vector<double> work;
+
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        initRoots(P, gen, roots);
+
+        if (aberthIterate(P, roots, kMaxIterations, kTolerance, nullptr, work)) {
+            break;
+        }
+    }
 
     return roots;
 }
 
-struct Point {
-    double x, y;
-    double minDist;
-    int cluster;
+Analysis::AberthRootFinder::AberthRootFinder(int maxIterations, double tolerance)
+    : mMaxIterations(maxIterations),
+      mTolerance(tolerance),
+      mIterations(0),
+      mConverged(false),
+      mWarm(false),
+      mGen(0x5eed)
+{
+}
+
+const rpm::vector<std::complex<double>>& Analysis::AberthRootFinder::solve(const rpm::vector<double>& P)
+{
+    const int degree = static_cast<int>(P.size()) - 1;
+
+    mIterations = 0;
+    mConverged = false;
 
-    inline double distance(const Point& p) const {
-        return pow(x - p.x, 2.0) + pow(y - p.y, 2.0);
+    if (degree < 1) {
+        mRoots.clear();
+        mWarm = false;
+        mConverged = true;
+        return mRoots;
     }
-};
 
-rpm::vector<Point> kMeansClustering(rpm::vector<Point>& points, int epochs, int k)
-{
-    const int n = points.size();
+    if (mWarm && (int) mRoots.size() == degree) {
+        mConverged = aberthIterate(P, mRoots, mMaxIterations, mTolerance, &mIterations, mWork);
+    }
 
-    rpm::vector<Point> centroids(k);
-    rpm::vector<int> nPoints(k);
-    rpm::vector<double> sumX(k);
-    rpm::vector<double> sumY(k);
+    if (!mConverged) {
+        initRoots(P, mGen, mRoots);
+        mConverged = aberthIterate(P, mRoots, mMaxIterations, mTolerance, &mIterations, mWork);
+    }
 
-    // Pick centroids at random
-    for (int i = 0; i < k; ++i) {
-        centroids[i] = points[gen() % n];
+    // Unconverged roots would be a poor starting point for the next call,
+    // and non-finite ones are no roots at all.
+    mWarm = mConverged;
+    if (!mConverged && !allRootsFinite(mRoots)) {
+        mRoots.clear();
     }
 
-    // Assign points to a cluster
-    for (int clusterId = 0; clusterId < k; ++clusterId) {
-        const auto& c = centroids[clusterId];
+    return mRoots;
+}
 
-        for (auto& p : points) {
-            const double dist = c.distance(p);
-            if (dist < p.minDist) {
-                p.minDist = dist;
-                p.cluster = clusterId;
+void Analysis::AberthRootFinder::reset()
+{
+    mWarm = false;
+    mRoots.clear();
+}
+
+int Analysis::AberthRootFinder::getIterationCount() const
+{
+    return mIterations;
+}
+
+bool Analysis::AberthRootFinder::hasConverged() const
+{
+    return mConverged;
+}
+
+// Lloyd's k-means on the roots, with a fixed number of epochs. The first centroid is the root
+// closest to the initial guess and every next one the root farthest from those already picked,
+// so the result only depends on the roots. Stops early once the assignment no longer changes.
+static void kMeansClustering(const rpm::vector<std::complex<double>>& points, int epochs, int k,
+        rpm::vector<std::complex<double>>& centroids, rpm::vector<int>& cluster, rpm::vector<double>& sums,
+        const std::complex<double>& initial)
+{
+    const int n = (int) points.size();
+
+    centroids.resize(k);
+    cluster.assign(n, -1);
+    sums.resize(3 * k);
+
+    double *sumX = sums.data();
+    double *sumY = sumX + k;
+    double *nPoints = sumY + k;
+
+    int first = 0;
+    for (int i = 1; i < n; ++i) {
+        if (std::norm(points[i] - initial) < std::norm(points[first] - initial))
+            first = i;
+    }
+    centroids[0] = points[first];
+
+    for (int c = 1; c < k; ++c) {
+        int farthest = 0;
+        double farthestDist = -1.0;
+        for (int i = 0; i < n; ++i) {
+            double minDist = std::numeric_limits<double>::max();
+            for (int j = 0; j < c; ++j)
+                minDist = std::min(minDist, std::norm(points[i] - centroids[j]));
+            if (minDist > farthestDist) {
+                farthestDist = minDist;
+                farthest = i;
             }
         }
+        centroids[c] = points[farthest];
     }
-    
-    for (int iter = 0; iter < epochs; ++iter) {
-        std::fill(nPoints.begin(), nPoints.end(), 0);
-        std::fill(sumX.begin(), sumX.end(), 0.0);
-        std::fill(sumY.begin(), sumY.end(), 0.0);
-
-        // Iterate over points to append data to centroids
-        for (auto& p : points) {
-            const int clusterId = p.cluster;
-            nPoints[clusterId] += 1;
-            sumX[clusterId] += p.x;
-            sumY[clusterId] += p.y;
-            p.minDist = std::numeric_limits<double>::max();
-        }
-
-        // Compute the new centroids
-        for (int clusterId = 0; clusterId < k; ++clusterId) {
-            auto& c = centroids[clusterId];
-            c.x = sumX[clusterId] / nPoints[clusterId];
-            c.y = sumY[clusterId] / nPoints[clusterId];
-        }
 
+    for (int iter = 0; iter <= epochs; ++iter) {
         // Assign points to a cluster
-        for (int clusterId = 0; clusterId < k; ++clusterId) {
-            const auto& c = centroids[clusterId];
-
-            for (auto& p : points) {
-                const double dist = c.distance(p);
-                if (dist < p.minDist) {
-                    p.minDist = dist;
-                    p.cluster = clusterId;
+        bool changed = false;
+        for (int i = 0; i < n; ++i) {
+            int best = 0;
+            double bestDist = std::norm(points[i] - centroids[0]);
+            for (int c = 1; c < k; ++c) {
+                const double dist = std::norm(points[i] - centroids[c]);
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = c;
                 }
             }
+            if (cluster[i] != best) {
+                cluster[i] = best;
+                changed = true;
+            }
         }
-    }
 
-    return centroids;
+        if (!changed || iter == epochs)
+            break;
+
+        // Compute the new centroids, leaving empty clusters where they are.
+        std::fill(sums.begin(), sums.end(), 0.0);
+        for (int i = 0; i < n; ++i) {
+            const int c = cluster[i];
+            sumX[c] += points[i].real();
+            sumY[c] += points[i].imag();
+            nPoints[c] += 1.0;
+        }
+        for (int c = 0; c < k; ++c) {
+            if (nPoints[c] > 0)
+                centroids[c] = { sumX[c] / nPoints[c], sumY[c] / nPoints[c] };
+        }
+    }
 }
 
-rpm::vector<std::complex<double>> Analysis::aberthRootsAroundInitial(
-        const rpm::vector<double>& P, double r, double phi, int count)
+void Analysis::AberthClusterWork::reserve(int degree)
 {
-    static std::uniform_real_distribution<> radius(r - 0.15, r + 0.15);
-    static std::uniform_real_distribution<> angle(phi - 0.15, phi + 0.15);
+    roots.reserve(degree);
+    work.reserve(8 * degree);
+    cluster.reserve(degree);
+    sums.reserve(3 * degree);
+}
 
+bool Analysis::aberthRootsAroundInitial(
+        const rpm::vector<double>& P, double r, double phi, int count,
+        rpm::vector<std::complex<double>>& centroids, AberthClusterWork& scratch)
+{
     const int degree = static_cast<int>(P.size()) - 1;
-    rpm::vector<std::complex<double>> roots;
-    for (int i = 0; i < degree; ++i) {
-        roots.push_back(std::polar(radius(gen), angle(gen)));
+    count = std::min(count, degree);
+    if (count <= 0) {
+        centroids.clear();
+        return false;
     }
-   
-    aberthIterate(P, roots);
 
-    rpm::vector<Point> points(degree);
+    // Start points spread over the box around (r, phi) along a golden-ratio sequence.
+    constexpr double golden = 0.6180339887498949;
+    auto& roots = scratch.roots;
+    roots.resize(degree);
     for (int i = 0; i < degree; ++i) {
-        points[i].x = roots[i].real();
-        points[i].y = roots[i].imag();
-        points[i].minDist = std::numeric_limits<double>::max();
+        const double u = (i + 0.5) / degree;
+        const double v = std::fmod(0.5 + i * golden, 1.0);
+        roots[i] = std::polar(r - 0.15 + 0.3 * u, phi - 0.15 + 0.3 * v);
     }
 
-    auto centroids = kMeansClustering(points, 20, count);
-    rpm::vector<std::complex<double>> pickedRoots;
-    for (const auto& c : centroids) {
-        pickedRoots.push_back({c.x, c.y});
+    if (!aberthIterate(P, roots, kMaxIterations, kTolerance, nullptr, scratch.work)) {
+        centroids.clear();
+        return false;
     }
 
+    kMeansClustering(roots, 20, count, centroids, scratch.cluster, scratch.sums, std::polar(r, phi));
+    return true;
+}
+
+rpm::vector<std::complex<double>> Analysis::aberthRootsAroundInitial(
+        const rpm::vector<double>& P, double r, double phi, int count)
+{
+    AberthClusterWork scratch;
+    rpm::vector<std::complex<double>> pickedRoots;
+    aberthRootsAroundInitial(P, r, phi, count, pickedRoots, scratch);
     return pickedRoots;
 }
@@ -3,11 +3,57 @@
 
 #include <rpcxx.h>
 #include <complex>
+#include <random>
 
 namespace Analysis {
 
+// Stateful Aberth-Ehrlich solver for polynomials that change slowly between calls.
+// Each call starts from the previous roots when the degree matches, and falls back
+// to a random start when the warm start does not converge within the iteration budget.
+class AberthRootFinder {
+public:
+    AberthRootFinder(int maxIterations = 50, double tolerance = 1e-10);
+
+    const rpm::vector<std::complex<double>>& solve(const rpm::vector<double>& P);
+
+    void reset();
+
+    int getIterationCount() const;
+    bool hasConverged() const;
+
+private:
+    int mMaxIterations;
+    double mTolerance;
+
+    int mIterations;
+    bool mConverged;
+    bool mWarm;
+
+    rpm::vector<std::complex<double>> mRoots;
+    rpm::vector<double> mWork;
+    std::mt19937_64 mGen;
+};
+
 rpm::vector<std::complex<double>> aberthRoots(const rpm::vector<double>& P);
 
+// Scratch for aberthRootsAroundInitial, kept by the caller so that repeated calls do not allocate.
+struct AberthClusterWork {
+    // Sizes the buffers for polynomials up to the given degree.
+    void reserve(int degree);
+
+    rpm::vector<std::complex<double>> roots;
+    rpm::vector<double> work;
+    rpm::vector<int> cluster;
+    rpm::vector<double> sums;
+};
+
+// Solves from start points around (r, phi) and reduces the roots to count cluster centres.
+// Deterministic: the result only depends on the arguments.
+// Returns false, with no centres, if the iteration did not converge to finite roots.
+bool aberthRootsAroundInitial(
+        const rpm::vector<double>& P, double r, double phi, int count,
+        rpm::vector<std::complex<double>>& centroids, AberthClusterWork& scratch);
+
 rpm::vector<std::complex<double>> aberthRootsAroundInitial(
         const rpm::vector<double>& P, double r, double phi, int count);
 
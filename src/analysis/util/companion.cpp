@@ -0,0 +1,137 @@
+#include "companion.h"
+#include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+#include <cmath>
+
+using namespace Analysis;
+
+template<typename Matrix>
+static void balance(Matrix& A)
+{
+    // Parlett-Reinsch balancing with power-of-two factors, so that no rounding is introduced.
+    const int n = (int) A.rows();
+
+    bool converged = false;
+    while (!converged) {
+        converged = true;
+
+        for (int i = 0; i < n; ++i) {
+            const double c = A.col(i).cwiseAbs().sum() - std::abs(A(i, i));
+            const double r = A.row(i).cwiseAbs().sum() - std::abs(A(i, i));
+
+            if (c == 0.0 || r == 0.0) {
+                continue;
+            }
+
+            double f = 1.0;
+            double cs = c;
+            while (cs < r / 2.0) {
+                cs *= 4.0;
+                f *= 2.0;
+            }
+            while (cs >= r * 2.0) {
+                cs /= 4.0;
+                f /= 2.0;
+            }
+
+            if ((c * f * f + r) / f < 0.95 * (c + r)) {
+                converged = false;
+                A.row(i) /= f;
+                A.col(i) *= f;
+            }
+        }
+    }
+}
+
+template<typename Matrix>
+static bool solveCompanion(const rpm::vector<double>& P, Matrix& A, rpm::vector<std::complex<double>>& roots)
+{
+    const int n = (int) A.rows();
+
+    // Upper Hessenberg companion matrix: -P[1..n] / P[0] on the first row, ones below the diagonal.
+    A.setZero();
+    for (int j = 0; j < n; ++j) {
+        A(0, j) = -P[j + 1] / P[0];
+    }
+    for (int i = 1; i < n; ++i) {
+        A(i, i - 1) = 1.0;
+    }
+
+    balance(A);
+
+    // Balancing keeps the Hessenberg structure, so the QR iteration can start directly.
+    Eigen::RealSchur<Matrix> schur(n);
+    schur.computeFromHessenberg(A, Matrix::Identity(n, n), false);
+
+    if (schur.info() != Eigen::Success) {
+        return false;
+    }
+
+    const Matrix& T = schur.matrixT();
+
+    roots.resize(n);
+
+    int i = 0;
+    while (i < n) {
+        if (i == n - 1 || T(i + 1, i) == 0.0) {
+            roots[i] = T(i, i);
+            i++;
+        }
+        else {
+            // 2x2 diagonal block holding a complex conjugate pair.
+            const double p = 0.5 * (T(i, i) - T(i + 1, i + 1));
+            const double t0 = T(i + 1, i);
+            const double t1 = T(i, i + 1);
+            const double scale = std::max(std::abs(p), std::max(std::abs(t0), std::abs(t1)));
+            const double ps = p / scale;
+            const double z = scale * std::sqrt(std::abs(ps * ps + (t0 / scale) * (t1 / scale)));
+
+            roots[i] = std::complex<double>(T(i + 1, i + 1) + p, z);
+            roots[i + 1] = std::complex<double>(T(i + 1, i + 1) + p, -z);
+            i += 2;
+        }
+    }
+
+    return true;
+}
+
+template<int N>
+static bool solveFixed(const rpm::vector<double>& P, rpm::vector<std::complex<double>>& roots)
+{
+    Eigen::Matrix<double, N, N> A;
+    return solveCompanion(P, A, roots);
+}
+
+static bool solveDynamic(const rpm::vector<double>& P, rpm::vector<std::complex<double>>& roots)
+{
+    const int n = static_cast<int>(P.size()) - 1;
+    Eigen::MatrixXd A(n, n);
+    return solveCompanion(P, A, roots);
+}
+
+bool Analysis::companionRoots(const rpm::vector<double>& P, rpm::vector<std::complex<double>>& roots)
+{
+    const int degree = static_cast<int>(P.size()) - 1;
+
+    if (degree < 1) {
+        roots.clear();
+        return true;
+    }
+
+    switch (degree) {
+    case 8:  return solveFixed<8>(P, roots);
+    case 9:  return solveFixed<9>(P, roots);
+    case 10: return solveFixed<10>(P, roots);
+    case 11: return solveFixed<11>(P, roots);
+    case 12: return solveFixed<12>(P, roots);
+    case 13: return solveFixed<13>(P, roots);
+    case 14: return solveFixed<14>(P, roots);
+    case 15: return solveFixed<15>(P, roots);
+    case 16: return solveFixed<16>(P, roots);
+    case 17: return solveFixed<17>(P, roots);
+    case 18: return solveFixed<18>(P, roots);
+    case 19: return solveFixed<19>(P, roots);
+    case 20: return solveFixed<20>(P, roots);
+    default: return solveDynamic(P, roots);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef ANALYSIS_UTIL_COMPANION_H
+#define ANALYSIS_UTIL_COMPANION_H
+
+#include <rpcxx.h>
+#include <complex>
+
+namespace Analysis {
+
+// Roots of P (highest degree coefficient first) as the eigenvalues of its companion matrix.
+// Degrees 8 to 20 use fixed-size matrices, other degrees fall back to a dynamic-size matrix.
+// Returns false if the QR iteration did not converge.
+bool companionRoots(const rpm::vector<double>& P, rpm::vector<std::complex<double>>& roots);
+
+}
+
+#endif // ANALYSIS_UTIL_COMPANION_H
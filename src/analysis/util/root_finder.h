@@ -0,0 +1,38 @@
+#ifndef ANALYSIS_UTIL_ROOT_FINDER_H
+#define ANALYSIS_UTIL_ROOT_FINDER_H
+
+#include <rpcxx.h>
+#include <complex>
+#include "aberth.h"
+
+namespace Analysis {
+
+enum class RootSolver {
+    Aberth,
+    Companion,
+};
+
+// Root finder with a selectable backend, for callers that solve one polynomial per frame.
+// By default the backend is picked per degree as in findRoots. Aberth keeps its warm start
+// between calls, and the companion backend falls back to it if the QR iteration fails.
+// The returned roots are valid until the next call.
+class RootFinder {
+public:
+    RootFinder();
+
+    const rpm::vector<std::complex<double>>& solve(const rpm::vector<double>& P);
+
+    void setSolver(RootSolver solver);
+    void setPreferredSolver();
+
+private:
+    bool mPreferred;
+    RootSolver mSolver;
+
+    AberthRootFinder mAberth;
+    rpm::vector<std::complex<double>> mRoots;
+};
+
+}
+
+#endif // ANALYSIS_UTIL_ROOT_FINDER_H
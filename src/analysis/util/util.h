@@ -6,16 +6,30 @@
 #include <complex>
 
 #include "../formant/formant.h"
+#include "root_finder.h"
 
 namespace Analysis {
 
     rpm::vector<int> findPeaks(const double *data, int length, int sign = +1);
 
+    // findPeaks with its buffers kept between calls, so that steady-state calls do not allocate.
+    // The returned peaks are valid until the next call.
+    class PeakFinder {
+    public:
+        const rpm::vector<int>& find(const double *data, int length, int sign = +1);
+
+    private:
+        rpm::vector<double> mValues;
+        rpm::vector<int> mIndices;
+        rpm::vector<int> mPeaks;
+    };
+
     std::pair<rpm::vector<double>, rpm::vector<double>> findZerocros(const rpm::vector<double>& y, char m);
 
     std::pair<double, double> parabolicInterpolation(const rpm::vector<double>& array, int x);
     
     rpm::vector<std::complex<double>> findRoots(const rpm::vector<double>& p);
+    rpm::vector<std::complex<double>> findRoots(const rpm::vector<double>& p, RootSolver solver);
 
     FormantData calculateFormant(double r, double phi, double sampleRate);
 
@@ -0,0 +1,25 @@
+#ifndef ANALYSIS_WINDOW_H
+#define ANALYSIS_WINDOW_H
+
+#include "../fft/fft.h"
+
+namespace Analysis {
+
+    enum class WindowType {
+        Hann,
+        Hamming,
+        BlackmanHarris,
+        Gaussian,
+    };
+
+    // Symmetric window of the given length, computed on first use and kept for the life of
+    // the program, so the view stays valid. Safe to call from any thread. The samples are
+    // aligned for the SIMD kernels. param is the Gaussian's alpha and is ignored otherwise.
+    BufferView<const double> getWindow(WindowType type, int length, double param = 0.0);
+
+    // out[i] = in[i] * window[i] over the window's length. out may alias in.
+    void applyWindow(const double *in, BufferView<const double> window, double *out);
+
+}
+
+#endif // ANALYSIS_WINDOW_H
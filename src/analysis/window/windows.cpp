@@ -0,0 +1,85 @@
+#include "window.h"
+#include "../filter/filter.h"
+#include "../simd/aligned.h"
+#include "../simd/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+
+using namespace Analysis;
+
+using WindowKey = std::tuple<WindowType, int, double>;
+
+static void computeWindow(WindowType type, int L, double param, double *w)
+{
+    if (L == 1) {
+        w[0] = 1.0;
+        return;
+    }
+
+    switch (type) {
+    case WindowType::Hann:
+        for (int i = 0; i < L; ++i) {
+            w[i] = 0.5 - 0.5 * cos((2.0 * M_PI * i) / (L - 1));
+        }
+        break;
+    case WindowType::Hamming:
+        for (int i = 0; i < L; ++i) {
+            w[i] = 0.54 - 0.46 * cos((2.0 * M_PI * i) / (L - 1));
+        }
+        break;
+    case WindowType::BlackmanHarris: {
+        const auto bh = blackmanHarrisWindow(L);
+        std::copy(bh.begin(), bh.end(), w);
+        break;
+    }
+    case WindowType::Gaussian: {
+        const auto g = gaussianWindow(L, param);
+        std::copy(g.begin(), g.end(), w);
+        break;
+    }
+    default:
+        throw std::runtime_error("Window::getWindow] Unknown window type");
+    }
+}
+
+// Entries are never removed, so the views handed out stay valid. std::map nodes don't move
+// on insertion, and neither do the vectors' buffers.
+BufferView<const double> Analysis::getWindow(WindowType type, int length, double param)
+{
+    static std::map<WindowKey, SIMD::AlignedVector<double>> cache;
+    static std::shared_mutex mutex;
+
+    if (length < 1) {
+        throw std::runtime_error("Window::getWindow] Length must be positive");
+    }
+
+    if (type != WindowType::Gaussian) {
+        param = 0.0;
+    }
+    const WindowKey key(type, length, param);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return BufferView<const double>(it->second.data(), length);
+        }
+    }
+
+    // Another thread may have inserted the same window meanwhile, in which case its copy wins.
+    SIMD::AlignedVector<double> window(length);
+    computeWindow(type, length, param, window.data());
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = cache.try_emplace(key, std::move(window)).first;
+    return BufferView<const double>(it->second.data(), length);
+}
+
+void Analysis::applyWindow(const double *in, BufferView<const double> window, double *out)
+{
+    SIMD::multiply(in, window.data(), out, window.size());
+}
@@ -218,6 +218,27 @@ void Config::setInvglotAlgorithm(int alg)
     setInvglotAlgorithm(static_cast<InvglotAlgorithm>(alg));
 }
 
+SpectrogramAlgorithm Config::getSpectrogramAlgorithm()
+{
+    return enumField(mTbl["solvers"], "spectrogram", SpectrogramAlgorithm::Standard);
+}
+
+void Config::setSpectrogramAlgorithm(SpectrogramAlgorithm alg)
+{
+    mTbl["solvers"]["spectrogram"].ref<int64_t>() = enumInt(alg);
+    emit spectrogramAlgorithmChanged(enumInt(alg));
+}
+
+int Config::getSpectrogramAlgorithmNumeric()
+{
+    return enumInt(getSpectrogramAlgorithm());
+}
+
+void Config::setSpectrogramAlgorithm(int alg)
+{
+    setSpectrogramAlgorithm(static_cast<SpectrogramAlgorithm>(alg));
+}
+
 double Config::getViewZoom()
 {
     return doubleField(mTbl["view"], "zoomScale", 1.0);
@@ -421,6 +442,22 @@ double Config::getAnalysisSpectrogramWindow() {
     return doubleField(mTbl["analysis"], "spectrogramWindow", 50.0);
 }
 
+void Config::setAnalysisSpectrogramSliding(bool b) {
+    mTbl["analysis"]["spectrogramSliding"].ref<bool>() = b;
+}
+
+bool Config::getAnalysisSpectrogramSliding() {
+    return boolField(mTbl["analysis"], "spectrogramSliding", false);
+}
+
+void Config::setAnalysisSpectrogramBands(int n) {
+    mTbl["analysis"]["spectrogramBands"].ref<int64_t>() = n;
+}
+
+int Config::getAnalysisSpectrogramBands() {
+    return integerField(mTbl["analysis"], "spectrogramBands", 0);
+}
+
 void Config::setAnalysisPitchWindow(double ms) {
     mTbl["analysis"]["pitchWindow"].ref<double>() = ms;
 }
@@ -461,6 +498,22 @@ double Config::getAnalysisFormantSpacing() {
     return doubleField(mTbl["analysis"], "formantSpacing", 80.0);
 }
 
+void Config::setAnalysisDeepFormantsBatch(int n) {
+    mTbl["analysis"]["deepFormantsBatch"].ref<int64_t>() = n;
+}
+
+int Config::getAnalysisDeepFormantsBatch() {
+    return integerField(mTbl["analysis"], "deepFormantsBatch", 1);
+}
+
+void Config::setAnalysisTorchThreads(int n) {
+    mTbl["analysis"]["torchThreads"].ref<int64_t>() = n;
+}
+
+int Config::getAnalysisTorchThreads() {
+    return integerField(mTbl["analysis"], "torchThreads", 0);
+}
+
 void Config::setAnalysisOscilloscopeSpacing(double ms) {
     mTbl["analysis"]["oscilloscopeSpacing"].ref<double>() = ms;
 }
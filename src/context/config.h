@@ -21,6 +21,7 @@ namespace Main {
         Q_PROPERTY(int linpredAlgorithm     READ getLinpredAlgorithmNumeric     WRITE setLinpredAlgorithm       NOTIFY linpredAlgorithmChanged)
         Q_PROPERTY(int formantAlgorithm     READ getFormantAlgorithmNumeric     WRITE setFormantAlgorithm       NOTIFY formantAlgorithmChanged)
         Q_PROPERTY(int invglotAlgorithm     READ getInvglotAlgorithmNumeric     WRITE setInvglotAlgorithm       NOTIFY invglotAlgorithmChanged)
+        Q_PROPERTY(int spectrogramAlgorithm READ getSpectrogramAlgorithmNumeric WRITE setSpectrogramAlgorithm   NOTIFY spectrogramAlgorithmChanged)
         Q_PROPERTY(double viewZoom          READ getViewZoom                    WRITE setViewZoom               NOTIFY viewZoomChanged)
         Q_PROPERTY(int viewMinFrequency     READ getViewMinFrequency            WRITE setViewMinFrequency       NOTIFY viewMinFrequencyChanged)
         Q_PROPERTY(int viewMaxFrequency     READ getViewMaxFrequency            WRITE setViewMaxFrequency       NOTIFY viewMaxFrequencyChanged)
@@ -38,6 +39,7 @@ namespace Main {
         void linpredAlgorithmChanged(int);
         void formantAlgorithmChanged(int);
         void invglotAlgorithmChanged(int);
+        void spectrogramAlgorithmChanged(int);
         void audioBackendChanged(int);
         void viewZoomChanged(double);
         void viewMinFrequencyChanged(int);
@@ -82,6 +84,12 @@ namespace Main {
         int getInvglotAlgorithmNumeric();
         void setInvglotAlgorithm(int alg);
 
+        SpectrogramAlgorithm getSpectrogramAlgorithm();
+        void setSpectrogramAlgorithm(SpectrogramAlgorithm alg);
+        
+        int getSpectrogramAlgorithmNumeric();
+        void setSpectrogramAlgorithm(int alg);
+
         double getViewZoom();
         void setViewZoom(double scale);
 
@@ -128,6 +136,12 @@ namespace Main {
         void setAnalysisSpectrogramWindow(double ms); // default is 50ms
         double getAnalysisSpectrogramWindow();
 
+        void setAnalysisSpectrogramSliding(bool b); // default is false
+        bool getAnalysisSpectrogramSliding();
+
+        void setAnalysisSpectrogramBands(int n); // default is 0, for the full FFT
+        int getAnalysisSpectrogramBands();
+
         void setAnalysisPitchWindow(double ms); // default is 40ms
         double getAnalysisPitchWindow();
 
@@ -143,6 +157,12 @@ namespace Main {
         void setAnalysisFormantSpacing(double ms); // default is 80ms
         double getAnalysisFormantSpacing();
 
+        void setAnalysisDeepFormantsBatch(int n); // default is 1, for one forward pass per frame
+        int getAnalysisDeepFormantsBatch();
+
+        void setAnalysisTorchThreads(int n); // default is 0, for libtorch's own choice
+        int getAnalysisTorchThreads();
+
         void setAnalysisOscilloscopeSpacing(double ms); // default is 160ms
         double getAnalysisOscilloscopeSpacing();
 
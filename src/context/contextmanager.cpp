@@ -17,6 +17,7 @@ ContextManager::ContextManager(
       mLinpredSolver(makeLinpredSolver(mConfig->getLinpredAlgorithm())),
       mFormantSolver(makeFormantSolver(mConfig->getFormantAlgorithm())),
       mInvglotSolver(makeInvglotSolver(mConfig->getInvglotAlgorithm())),
+      mSpectrogramEngine(makeSpectrogramEngine(mConfig->getSpectrogramAlgorithm())),
       mCaptureBuffer(std::make_unique<Audio::Buffer>(captureSampleRate)),
       mPlaybackQueue(std::make_unique<Audio::Queue>(
                   playbackBlockDuration.count(),
@@ -25,7 +26,8 @@ ContextManager::ContextManager(
       mPipeline(std::make_unique<App::Pipeline>(
                   mCaptureBuffer.get(), mDataStore.get(), mConfig.get(),
                   mPitchSolver, mLinpredSolver,
-                  mFormantSolver, mInvglotSolver)),
+                  mFormantSolver, mInvglotSolver,
+                  mSpectrogramEngine)),
 #ifndef WITHOUT_SYNTH
       mSynthesizer(std::make_unique<App::Synthesizer>(mPlaybackQueue.get())),
 #endif
@@ -43,6 +45,7 @@ ContextManager::ContextManager(
 #ifdef ENABLE_TORCH
     // Load the DF model.
     DFModelHolder::initialize(&mDfModelHolder);
+    mDfModelHolder->setNumThreads(mConfig->getAnalysisTorchThreads());
 #endif
 
     createViews();
@@ -64,6 +67,10 @@ ContextManager::ContextManager(
             [this](int index) {
                 mInvglotSolver.reset(makeInvglotSolver(static_cast<InvglotAlgorithm>(index)));
             });
+    QObject::connect(mConfig.get(), &Config::spectrogramAlgorithmChanged,
+            [this](int index) {
+                mSpectrogramEngine.reset(makeSpectrogramEngine(static_cast<SpectrogramAlgorithm>(index)));
+            });
     QObject::connect(mConfig.get(), &Config::audioBackendChanged,
             [this](int index) {
                 mAudioContext = std::make_unique<AudioContext>(
@@ -181,7 +188,6 @@ void ContextManager::datavisThreadLoop()
     rpm::vector<std::complex<double>> wn(frequencies.size());
 
     double maxFrequencySource = 16000;
-    rpm::map<int, rpm::vector<double>> fftWindowCache;
     Analysis::RealFFT fft(512);
     rpm::vector<double> fftFrequencies(fft.getOutputLength());
     for (int k = 0; k < fftFrequencies.size(); ++k) {
@@ -256,7 +262,7 @@ void ContextManager::datavisThreadLoop()
         auto source = mSynthesizer->getSourceCopy(maxFrequencySource * 2, 25.0);
         mSynthWrapper.setSource(source, maxFrequencySource * 2);
 
-        auto sourceSpectrum = Analysis::fft_n(&fft, source, fftWindowCache);
+        auto sourceSpectrum = Analysis::fft_n(&fft, source);
         mSynthWrapper.setSourceSpectrum(fftFrequencies, sourceSpectrum);
 #endif // !WITHOUT_SYNTH
 
@@ -76,6 +76,7 @@ namespace Main {
         std::shared_ptr<Analysis::LinpredSolver> mLinpredSolver;
         std::shared_ptr<Analysis::FormantSolver> mFormantSolver;
         std::shared_ptr<Analysis::InvglotSolver> mInvglotSolver;
+        std::shared_ptr<Analysis::SpectrogramEngine> mSpectrogramEngine;
 
 #ifdef ENABLE_TORCH
         DFModelHolder *mDfModelHolder;
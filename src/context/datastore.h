@@ -21,6 +21,11 @@ namespace Main {
     struct SpectrogramCoefs {
         rpm::vector<double> magnitudes;
         double sampleRate;
+        // The magnitudes are spaced evenly on scale, from minFrequency for the first
+        // to maxFrequency for the last.
+        FrequencyScale scale = FrequencyScale::Linear;
+        double minFrequency = 0.0;
+        double maxFrequency = 0.0;
     };
 
     class DataStore {
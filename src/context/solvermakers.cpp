@@ -12,6 +12,10 @@ Analysis::PitchSolver *Main::makePitchSolver(PitchAlgorithm alg)
         return new Analysis::Pitch::MPM;
     case PitchAlgorithm::RAPT:
         return new Analysis::Pitch::RAPT;
+    case PitchAlgorithm::IRAPT:
+        return new Analysis::Pitch::IRAPT;
+    case PitchAlgorithm::AMDF_M:
+        return new Analysis::Pitch::AMDF_M(60, 500, 0.3);
     default:
         throw std::runtime_error("ContextManager] Unknown pitch estimation algorithm.");
     }
@@ -38,6 +42,8 @@ Analysis::FormantSolver *Main::makeFormantSolver(FormantAlgorithm alg)
         return new Analysis::Formant::SimpleLP;
     case FormantAlgorithm::Filtered:
         return new Analysis::Formant::FilteredLP;
+    case FormantAlgorithm::Karma:
+        return new Analysis::Formant::Karma;
 #ifdef ENABLE_TORCH
     case FormantAlgorithm::Deep:
         return new Analysis::Formant::DeepFormants;
@@ -59,3 +65,19 @@ Analysis::InvglotSolver *Main::makeInvglotSolver(InvglotAlgorithm alg)
         throw std::runtime_error("ContextManager] Unknown glottal inverse filtering algorithm.");
     }
 }
+
+Analysis::SpectrogramEngine *Main::makeSpectrogramEngine(SpectrogramAlgorithm alg)
+{
+    switch (alg) {
+    case SpectrogramAlgorithm::Standard:
+        return new Analysis::Spectrogram::Standard;
+    case SpectrogramAlgorithm::Reassigned:
+        return new Analysis::Spectrogram::Reassigned;
+    case SpectrogramAlgorithm::Multitaper:
+        return new Analysis::Spectrogram::Multitaper;
+    case SpectrogramAlgorithm::ConstantQ:
+        return new Analysis::Spectrogram::ConstantQ;
+    default:
+        throw std::runtime_error("ContextManager] Unknown spectrogram algorithm.");
+    }
+}
@@ -9,6 +9,8 @@ namespace Main {
         Yin,
         MPM,
         RAPT,
+        IRAPT,
+        AMDF_M,
     };
     
     Analysis::PitchSolver *makePitchSolver(PitchAlgorithm alg);
@@ -24,6 +26,7 @@ namespace Main {
     enum class FormantAlgorithm : int64_t {
         Simple,
         Filtered,
+        Karma,
         Deep,
     };
 
@@ -36,6 +39,15 @@ namespace Main {
 
     Analysis::InvglotSolver *makeInvglotSolver(InvglotAlgorithm alg);
 
+    enum class SpectrogramAlgorithm : int64_t {
+        Standard,
+        Reassigned,
+        Multitaper,
+        ConstantQ,
+    };
+
+    Analysis::SpectrogramEngine *makeSpectrogramEngine(SpectrogramAlgorithm alg);
+
 }
 
 #endif // MAIN_SOLVER_MAKERS_H
@@ -50,11 +50,11 @@ void CanvasRenderer::initialize(Main::RenderContext *renderContext)
     initFonts();
     initShaders();
 
-    initTexture(mSpecTex, 2048, 4096+2);
+    initTexture(mSpecTex, 2048, 4096+4);
     
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, mSpecTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 2048, 4096+2, 0, GL_RED, GL_FLOAT, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 2048, 4096+4, 0, GL_RED, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -304,7 +304,9 @@ void CanvasRenderer::drawSpectrogram(
         int chunkSize2,
         int totalSize,
         const std::array<GLint, 2048>& nffts,
-        const std::array<GLfloat, 2048>& sampleRates,
+        const std::array<GLint, 2048>& frequencyScales,
+        const std::array<GLfloat, 2048>& minFrequencies,
+        const std::array<GLfloat, 2048>& maxFrequencies,
         const rpm::vector<GLfloat>& chunkData1,
         const rpm::vector<GLfloat>& chunkData2,
         FrequencyScale freqScale,
@@ -327,12 +329,14 @@ void CanvasRenderer::drawSpectrogram(
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, chunkSize2, 4096, GL_RED, GL_FLOAT, chunkData2.data());
     }
 
-    std::array<GLfloat, 2048 * 2> extraData;
+    std::array<GLfloat, 2048 * 4> extraData;
     for (int x = 0; x < 2048; ++x) {
         extraData[0 * 2048 + x] = nffts[x];
-        extraData[1 * 2048 + x] = sampleRates[x];
+        extraData[1 * 2048 + x] = frequencyScales[x];
+        extraData[2 * 2048 + x] = minFrequencies[x];
+        extraData[3 * 2048 + x] = maxFrequencies[x];
     }
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 4096, 2048, 2, GL_RED, GL_FLOAT, extraData.data());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 4096, 2048, 4, GL_RED, GL_FLOAT, extraData.data());
 
     glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -369,7 +373,7 @@ void CanvasRenderer::drawSpectrogram(
     float texX1 = texOffX - float(totalSize + 1.0f) / 2048.0f;
     float texX2 = texOffX;
     float texY1 = 0.0f;
-    float texY2 = 4095.0f / 4098.0f;
+    float texY2 = 1.0f;
 
     float vertices[4][4] = {
         { x2, y1, texX2, texY2 },
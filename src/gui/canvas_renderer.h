@@ -53,7 +53,9 @@ namespace Gui {
                 int chunkSize2,
                 int totalSize,
                 const std::array<GLint, 2048>& nffts,
-                const std::array<GLfloat, 2048>& sampleRates,
+                const std::array<GLint, 2048>& frequencyScales,
+                const std::array<GLfloat, 2048>& minFrequencies,
+                const std::array<GLfloat, 2048>& maxFrequencies,
                 const rpm::vector<GLfloat>& chunkData1,
                 const rpm::vector<GLfloat>& chunkData2,
                 FrequencyScale freqScale,
@@ -79,7 +79,9 @@ void QPainterWrapper::drawSpectrogram(const rpm::vector<std::pair<double, Main::
     static int xOffset = 0;
 
     static std::array<GLint, texWidth> nffts;
-    static std::array<GLfloat, texWidth> sampleRates;
+    static std::array<GLint, texWidth> frequencyScales;
+    static std::array<GLfloat, texWidth> minFrequencies;
+    static std::array<GLfloat, texWidth> maxFrequencies;
 
     // Only render the slices that have not been rendered yet. 
 
@@ -120,7 +122,6 @@ void QPainterWrapper::drawSpectrogram(const rpm::vector<std::pair<double, Main::
             const auto& slice = slices[firstSliceIndexToRender + ioff].second;
             const auto& fftData = slice.magnitudes;
             const int nfft = (int) fftData.size();
-            const double sampleRate = slice.sampleRate;
 
             int index;
             if (ioff < sliceCount1) {
@@ -130,8 +131,12 @@ void QPainterWrapper::drawSpectrogram(const rpm::vector<std::pair<double, Main::
                 index = ioff;
             }
 
+            // Each column keeps the frequency layout it was computed with, so that it is still
+            // drawn in the right place after the view changes.
             nffts[index] = nfft;
-            sampleRates[index] = sampleRate;
+            frequencyScales[index] = static_cast<GLint>(slice.scale);
+            minFrequencies[index] = slice.minFrequency;
+            maxFrequencies[index] = slice.maxFrequency;
 
             for (int k = 0; k < nfft; ++k) {
                 if (ioff < sliceCount1) {
@@ -149,7 +154,9 @@ void QPainterWrapper::drawSpectrogram(const rpm::vector<std::pair<double, Main::
             sliceCount2,
             (int) slices.size(),
             nffts,
-            sampleRates,
+            frequencyScales,
+            minFrequencies,
+            maxFrequencies,
             data1,
             data2,
             mFrequencyScale,
@@ -172,7 +179,9 @@ void QPainterWrapper::drawSpectrogram(const rpm::vector<std::pair<double, Main::
             0,
             (int) slices.size(),
             nffts,
-            sampleRates,
+            frequencyScales,
+            minFrequencies,
+            maxFrequencies,
             emptyData,
             emptyData,
             mFrequencyScale,
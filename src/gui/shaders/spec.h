@@ -37,17 +37,21 @@ uniform float maxGain;
 #define INV_LOG_10  0.4342944819
 #define ERB_A       21.33228113095401739888262
 
-float transform(float f) {
-    if (frequencyScale == 1)
+float transformOn(int scale, float f) {
+    if (scale == 1)
         return log(f) * INV_LOG_2;
-    else if (frequencyScale == 2)
+    else if (scale == 2)
         return 2595.0 * log(1.0 + f / 700.0) * INV_LOG_10;
-    else if (frequencyScale == 3)
+    else if (scale == 3)
         return ERB_A * log(1.0 + 0.00437 * f) * INV_LOG_10;
     else
         return f;
 }
 
+float transform(float f) {
+    return transformOn(frequencyScale, f);
+}
+
 float reverse(float v) {
     if (frequencyScale == 1)
         return pow(2.0, v);
@@ -66,25 +70,30 @@ void main()
 
     int chunkIndex = int(floor(mod(TexCoords.x, 1.0) * 2048.0));
 
+    // Each column stores its row count, and the scale and frequencies of its first and last
+    // rows, which are spaced evenly on that scale.
     float txl_x = (2.0 * float(chunkIndex) + 1.0) / (2.0 * 2048.0);
-    float txl_y1 = (2.0 * 4096.0 + 1.0) / (2.0 * 4098.0);
-    float txl_y2 = (2.0 * 4097.0 + 1.0) / (2.0 * 4098.0);
+    float txl_y1 = (2.0 * 4096.0 + 1.0) / (2.0 * 4100.0);
+    float txl_y2 = (2.0 * 4097.0 + 1.0) / (2.0 * 4100.0);
+    float txl_y3 = (2.0 * 4098.0 + 1.0) / (2.0 * 4100.0);
+    float txl_y4 = (2.0 * 4099.0 + 1.0) / (2.0 * 4100.0);
 
-    int nfft = int(texture2D(tex, vec2(txl_x, txl_y1)));
-    float sampleRate = float(texture2D(tex, vec2(txl_x, txl_y2)));
+    int rowCount = int(texture2D(tex, vec2(txl_x, txl_y1)));
+    int rowScale = int(texture2D(tex, vec2(txl_x, txl_y2)));
+    float rowMinFrequency = float(texture2D(tex, vec2(txl_x, txl_y3)));
+    float rowMaxFrequency = float(texture2D(tex, vec2(txl_x, txl_y4)));
 
-    float ty = TexCoords.y;
+    float freq = reverse(transform(minFrequency) + TexCoords.y * (transform(maxFrequency) - transform(minFrequency)));
 
-    float freq = reverse(transform(minFrequency) + ty * (transform(maxFrequency) - transform(minFrequency)));
+    float rowMin = transformOn(rowScale, rowMinFrequency);
+    float rowMax = transformOn(rowScale, rowMaxFrequency);
+    float row = (transformOn(rowScale, freq) - rowMin) / (rowMax - rowMin) * float(rowCount - 1);
 
-    ty = freq / (sampleRate / 2.0);
-    
-    ty *= (float(nfft) / 4096.0);
-   
-    if (ty < 0.0 || ty >= 4096.0 / 4098.0) {
+    if (rowCount < 2 || row < -0.5 || row >= float(rowCount) - 0.5) {
         gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
     else {
+        float ty = (row + 0.5) / 4100.0;
         float amplitude = float(texture2D(tex, vec2(TexCoords.x, ty)));
 
         float adjusted = sqrt(amplitude / pow(10.0, maxGain / 20.0)) * 7.0;
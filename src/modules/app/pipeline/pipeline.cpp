@@ -20,7 +20,8 @@ Pipeline::Pipeline(Module::Audio::Buffer *captureBuffer,
                 std::shared_ptr<Analysis::PitchSolver>& pitchSolver,
                 std::shared_ptr<Analysis::LinpredSolver>& linpredSolver,
                 std::shared_ptr<Analysis::FormantSolver>& formantSolver,
-                std::shared_ptr<Analysis::InvglotSolver>& invglotSolver)
+                std::shared_ptr<Analysis::InvglotSolver>& invglotSolver,
+                std::shared_ptr<Analysis::SpectrogramEngine>& spectrogramEngine)
     : mCaptureBuffer(captureBuffer),
       mDataStore(dataStore),
       mConfig(config),
@@ -29,8 +30,8 @@ Pipeline::Pipeline(Module::Audio::Buffer *captureBuffer,
       mStopThread(false),
       mBuffer(16000)
 {
-    mProcessors.push_back(std::make_unique<Processors::Spectrogram>(config, dataStore));
-    mProcessors.push_back(std::make_unique<Processors::Pitch>(config, dataStore, pitchSolver));
+    mProcessors.push_back(std::make_unique<Processors::Spectrogram>(config, dataStore, spectrogramEngine, &mSpectralFrames));
+    mProcessors.push_back(std::make_unique<Processors::Pitch>(config, dataStore, pitchSolver, &mSpectralFrames));
     mProcessors.push_back(std::make_unique<Processors::Formants>(config, dataStore, linpredSolver, formantSolver));
     mProcessors.push_back(std::make_unique<Processors::Oscilloscope>(config, dataStore, invglotSolver));
 }
@@ -73,6 +74,7 @@ void Pipeline::callbackProcessing()
                 std::next(slidingWindow.begin(), block.size()),
                 slidingWindow.end());
         std::copy(block.begin(), block.end(), std::prev(slidingWindow.end(), block.size()));
+        mSpectralFrames.nextHop();
 
         for (auto& processor : mProcessors) {
             if (processor->canProcess(time)) {
@@ -24,7 +24,8 @@ namespace Module::App
                 std::shared_ptr<Analysis::PitchSolver>& pitchSolver,
                 std::shared_ptr<Analysis::LinpredSolver>& linpredSolver,
                 std::shared_ptr<Analysis::FormantSolver>& formantSolver,
-                std::shared_ptr<Analysis::InvglotSolver>& invglotSolver);
+                std::shared_ptr<Analysis::InvglotSolver>& invglotSolver,
+                std::shared_ptr<Analysis::SpectrogramEngine>& spectrogramEngine);
         ~Pipeline();
 
         void processAll();
@@ -43,6 +44,9 @@ namespace Module::App
         Module::Audio::Buffer mBuffer;
         double mSampleRate;
 
+        // Transforms of the current hop, shared between the processors.
+        Analysis::SpectralFrames mSpectralFrames;
+
         rpm::vector<std::unique_ptr<Processors::BaseProcessor>> mProcessors; 
 
         void callbackProcessing();
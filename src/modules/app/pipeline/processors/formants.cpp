@@ -2,6 +2,12 @@
 
 #include "../../../../analysis/analysis.h"
 
+#ifdef WITH_ALLOCATION_CHECKS
+#   include "../../../../allocation_counter.h"
+#   include <cstdlib>
+#   include <iostream>
+#endif
+
 using namespace Module::App::Processors;
 
 Formants::Formants(Main::Config *config, Main::DataStore *dataStore,
@@ -14,17 +20,22 @@ Formants::Formants(Main::Config *config, Main::DataStore *dataStore,
       mLinpredSolver(linpredSolver),
       mFormantSolver(formantSolver),
       mLastSample(0.0)
+#ifdef WITH_ALLOCATION_CHECKS
+      , mCheckFrames(0)
+#endif
 {
 }
 
 void Formants::processData(const rpm::vector<double>& data, double sampleRate)
 {
+#ifdef WITH_ALLOCATION_CHECKS
+    const uint64_t allocationsBefore = threadAllocationCount();
+#endif
+
     constexpr double preemphFrequency = 200.0;
     const double preemphFactor = exp(-(2.0 * M_PI * preemphFrequency) / sampleRate);
 
-    if (mWindow.size() != data.size()) {
-        mWindow = Analysis::gaussianWindow((int) data.size(), 2.5);
-    }
+    const auto window = Analysis::getWindow(Analysis::WindowType::Gaussian, (int) data.size(), 2.5);
 
     constexpr double fsLPC = 11000;
     mResamplerLPC.setRate(sampleRate, fsLPC);
@@ -34,34 +45,71 @@ void Formants::processData(const rpm::vector<double>& data, double sampleRate)
     mResampler16k.setRate(sampleRate, fs16k);
 #endif
 
-    auto data2 = data;
+    auto& data2 = mPreemph;
+    data2.assign(data.begin(), data.end());
     for (int i = (int) data.size() - 1; i >= 1; --i) {
-        data2[i] = mWindow[i] * (data2[i] - preemphFactor * data2[i - 1]);
+        data2[i] = window[i] * (data2[i] - preemphFactor * data2[i - 1]);
     }
-    data2[0] = mWindow[0] * (data[0] - preemphFactor * mLastSample);
+    data2[0] = window[0] * (data[0] - preemphFactor * mLastSample);
     mLastSample = data[0];
 
-    auto mLPC = mResamplerLPC.process(data2);
-    
-    rpm::vector<double> lpc;
+    mResamplerLPC.process(data2, mFrameLPC);
 
 #ifdef ENABLE_TORCH
     if (auto dfSolver = dynamic_cast<Analysis::Formant::DeepFormants *>(mFormantSolver.get())) {
-        auto m16k = mResampler16k.process(data2);
-        dfSolver->setFrameAudio(m16k);
+        processDeepFormants(dfSolver, data2);
+        return;
     }
-    else {
 #endif
-        double gain;
-        lpc = mLinpredSolver->solve(mLPC.data(), (int) mLPC.size(), 10, &gain);
+    
+    std::array<double, 10> lpc;
+    double gain;
+    const int lpcOrder = mLinpredSolver->solve(mFrameLPC.data(), (int) mFrameLPC.size(), (int) lpc.size(), lpc.data(), &gain);
+
+    auto& formantResult = mFormantResult;
+    mFormantSolver->solve(lpc.data(), lpcOrder, fsLPC, formantResult);
+
+#ifdef WITH_ALLOCATION_CHECKS
+    checkSteadyState(threadAllocationCount() - allocationsBefore, (int) data.size(), sampleRate);
+#endif
+
+    mDataStore->beginWrite();
+    writeFormants(formantResult, getCenteredTime());
+    mDataStore->endWrite();
+}
+
 #ifdef ENABLE_TORCH
+// Frames are queued until the configured batch size is reached, then run through the model
+// in one forward pass and written out with their own times.
+void Formants::processDeepFormants(Analysis::Formant::DeepFormants *dfSolver, const rpm::vector<double>& data)
+{
+    // A solver that was just created has nothing queued.
+    if (dfSolver->queuedFrameCount() != (int) mQueuedTimes.size()) {
+        mQueuedTimes.clear();
     }
-#endif
 
-    auto formantResult = mFormantSolver->solve(lpc.data(), (int) lpc.size(), fsLPC);
+    dfSolver->queueFrameAudio(mResampler16k.process(data));
+    mQueuedTimes.push_back(getCenteredTime());
+
+    if (dfSolver->queuedFrameCount() < mConfig->getAnalysisDeepFormantsBatch()) {
+        return;
+    }
+
+    mQueuedResults.resize(mQueuedTimes.size());
+    dfSolver->solveQueued(mQueuedResults.data());
 
     mDataStore->beginWrite();
+    for (int i = 0; i < (int) mQueuedTimes.size(); ++i) {
+        writeFormants(mQueuedResults[i], mQueuedTimes[i]);
+    }
+    mDataStore->endWrite();
 
+    mQueuedTimes.clear();
+}
+#endif
+
+void Formants::writeFormants(const Analysis::FormantResult& formantResult, double time)
+{
     const int actualFormantCount = std::min(
         mDataStore->getFormantTrackCount(),
         (int) formantResult.formants.size());
@@ -69,16 +117,35 @@ void Formants::processData(const rpm::vector<double>& data, double sampleRate)
     for (int i = 0; i < actualFormantCount; ++i) {
         const double frequency = formantResult.formants[i].frequency;
         if (std::isnormal(frequency)) {
-            mDataStore->getFormantTrack(i).insert(getCenteredTime(), frequency);
+            mDataStore->getFormantTrack(i).insert(time, frequency);
         }
         else {
-            mDataStore->getFormantTrack(i).insert(getCenteredTime(), std::nullopt);
+            mDataStore->getFormantTrack(i).insert(time, std::nullopt);
         }
     }
 
     for (int i = (int) formantResult.formants.size(); i < mDataStore->getFormantTrackCount(); ++i) {
-        mDataStore->getFormantTrack(i).insert(getCenteredTime(), std::nullopt);
+        mDataStore->getFormantTrack(i).insert(time, std::nullopt);
     }
+}
 
-    mDataStore->endWrite();
-}
\ No newline at end of file
+#ifdef WITH_ALLOCATION_CHECKS
+// Frames only count as steady once the same frame length, rate and solvers have been seen
+// twice, so that the buffers and plans they need have been sized. Track storage in the
+// data store is not part of the check.
+void Formants::checkSteadyState(uint64_t allocations, int length, double sampleRate)
+{
+    const CheckKey key(length, sampleRate, mLinpredSolver.get(), mFormantSolver.get());
+    if (key != mCheckKey) {
+        mCheckKey = key;
+        mCheckFrames = 0;
+    }
+
+    if (mCheckFrames >= 2 && allocations > 0) {
+        std::cerr << "Processors::Formants] " << allocations
+                  << " heap allocations in a steady-state frame" << std::endl;
+        std::abort();
+    }
+    mCheckFrames++;
+}
+#endif
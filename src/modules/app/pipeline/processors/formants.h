@@ -3,7 +3,9 @@
 
 #include "rpcxx.h"
 
+#include <cstdint>
 #include <memory>
+#include <tuple>
 
 #include "../../../audio/resampler/resampler.h"
 #include "../../../../analysis/formant/formant.h"
@@ -23,15 +25,35 @@ namespace Module::App::Processors {
         void processData(const rpm::vector<double>& data, double sampleRate) override;
 
     private:
+        void writeFormants(const Analysis::FormantResult& formantResult, double time);
+
+#ifdef ENABLE_TORCH
+        void processDeepFormants(Analysis::Formant::DeepFormants *dfSolver, const rpm::vector<double>& data);
+#endif
+
+#ifdef WITH_ALLOCATION_CHECKS
+        void checkSteadyState(uint64_t allocations, int length, double sampleRate);
+
+        using CheckKey = std::tuple<int, double, const void *, const void *>;
+        CheckKey mCheckKey;
+        int mCheckFrames;
+#endif
+
         Main::Config *mConfig;
         Main::DataStore *mDataStore;
         std::shared_ptr<Analysis::LinpredSolver>& mLinpredSolver;
         std::shared_ptr<Analysis::FormantSolver>& mFormantSolver;
 
-        rpm::vector<double> mWindow;
         Module::Audio::Resampler mResamplerLPC;
+
+        // Per-frame buffers, kept so that steady-state frames do not allocate.
+        rpm::vector<double> mPreemph;
+        rpm::vector<double> mFrameLPC;
+        Analysis::FormantResult mFormantResult;
 #ifdef ENABLE_TORCH
         Module::Audio::Resampler mResampler16k;
+        rpm::vector<double> mQueuedTimes;
+        rpm::vector<Analysis::FormantResult> mQueuedResults;
 #endif
 
         double mLastSample;
@@ -5,26 +5,34 @@
 using namespace Module::App::Processors;
 
 Pitch::Pitch(Main::Config *config, Main::DataStore *dataStore,
-            std::shared_ptr<Analysis::PitchSolver>& pitchSolver)
+            std::shared_ptr<Analysis::PitchSolver>& pitchSolver,
+            Analysis::SpectralFrames *spectralFrames)
     : BaseProcessor(config->getAnalysisPitchSpacing(),
                     config->getAnalysisPitchWindow()),
       mConfig(config),
       mDataStore(dataStore),
-      mPitchSolver(pitchSolver)
+      mPitchSolver(pitchSolver),
+      mSpectralFrames(spectralFrames)
 {
 }
 
 void Pitch::processData(const rpm::vector<double>& data, double sampleRate)
 {
+    // The solver can be swapped between calls.
+    mPitchSolver->setSpectralFrames(mSpectralFrames);
+
     auto pitchResult = mPitchSolver->solve(data.data(), (int) data.size(), sampleRate);
 
+    // Solvers with lookahead return the decision for an earlier frame.
+    const double time = getCenteredTime() - mPitchSolver->getLatency() * getFrameSpace();
+
     mDataStore->beginWrite();
 
     if (pitchResult.voiced) {
-        mDataStore->getPitchTrack().insert(getCenteredTime(), pitchResult.pitch);
+        mDataStore->getPitchTrack().insert(time, pitchResult.pitch);
     }
     else {
-        mDataStore->getPitchTrack().insert(getCenteredTime(), std::nullopt);
+        mDataStore->getPitchTrack().insert(time, std::nullopt);
     }
 
     mDataStore->endWrite();
@@ -15,7 +15,8 @@ namespace Module::App::Processors {
     class Pitch : public BaseProcessor {
     public:
         Pitch(Main::Config *config, Main::DataStore *dataStore,
-            std::shared_ptr<Analysis::PitchSolver>& pitchSolver);
+            std::shared_ptr<Analysis::PitchSolver>& pitchSolver,
+            Analysis::SpectralFrames *spectralFrames);
         
         void processData(const rpm::vector<double>& data, double sampleRate) override;
 
@@ -23,6 +24,7 @@ namespace Module::App::Processors {
         Main::Config *mConfig;
         Main::DataStore *mDataStore;
         std::shared_ptr<Analysis::PitchSolver>& mPitchSolver;
+        Analysis::SpectralFrames *mSpectralFrames;
     };
 
 }
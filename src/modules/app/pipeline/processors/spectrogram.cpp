@@ -4,11 +4,32 @@
 
 using namespace Module::App::Processors;
 
-Spectrogram::Spectrogram(Main::Config *config, Main::DataStore *dataStore)
+static Eigen::SparseMatrix<double> makeFilterbank(FrequencyScale scale, double minFrequency, double maxFrequency,
+                                                  int bandCount, int binCount, double sampleRate)
+{
+    switch (scale) {
+    case FrequencyScale::Logarithmic:
+        return Analysis::logFilterbank(minFrequency, maxFrequency, bandCount, binCount, sampleRate);
+    case FrequencyScale::Mel:
+        return Analysis::melFilterbank(minFrequency, maxFrequency, bandCount, binCount, sampleRate);
+    case FrequencyScale::ERB:
+        return Analysis::erbFilterbank(minFrequency, maxFrequency, bandCount, binCount, sampleRate);
+    case FrequencyScale::Linear:
+    default:
+        return Analysis::linearFilterbank(minFrequency, maxFrequency, bandCount, binCount, sampleRate);
+    }
+}
+
+Spectrogram::Spectrogram(Main::Config *config, Main::DataStore *dataStore,
+            std::shared_ptr<Analysis::SpectrogramEngine>& spectrogramEngine,
+            Analysis::SpectralFrames *spectralFrames)
     : BaseProcessor(0.0,
                     config->getAnalysisGranularity()),
       mConfig(config),
       mDataStore(dataStore),
+      mSpectrogramEngine(spectrogramEngine),
+      mSpectralFrames(spectralFrames),
+      mSlidingSampleRate(0),
       mHighpassSampleRate(0),
       mHold(1.0)
 {
@@ -32,17 +53,59 @@ void Spectrogram::processData(const rpm::vector<double>& overlap, double sampleR
     // Apply highpass filter to it.
     outOverlap = Synthesis::sosfilter(mHighpass, outOverlap, mHighpassMemory);
 
-    // Sliding window for the spectrogram.
+    rpm::vector<double> fftVector;
+    Analysis::SpectrogramAxis axis { false, 0.0, 0.0 };
+    double centreOffset = fftSamples / 2.0;
+
+    // Sliding window for the spectrogram, kept up to date in both modes so that either can take over.
     mData.resize(fftSamples);
     std::rotate(mData.begin(), std::next(mData.begin(), outOverlap.size()), mData.end());
     std::copy(outOverlap.begin(), outOverlap.end(), std::prev(mData.end(), outOverlap.size()));
 
-    // Create the FFT processor.
-    if (!mFFT || mFFT->getInputLength() != fftSamples) {
-        mFFT = std::make_unique<Analysis::RealFFT>(fftSamples);
+    if (mConfig->getAnalysisSpectrogramSliding()) {
+        // Recursive mode: only the new samples go through the sliding DFT.
+        // A new one starts from the whole window, which already holds them.
+        if (!mSlidingDFT || mSlidingDFT->getLength() != fftSamples || mSlidingSampleRate != fsView) {
+            mSlidingDFT = std::make_unique<Analysis::SlidingDFT>(fftSamples);
+            mSlidingSampleRate = fsView;
+            mSlidingDFT->push(mData.data(), fftSamples);
+        }
+        else {
+            mSlidingDFT->push(outOverlap.data(), (int) outOverlap.size());
+        }
+
+        fftVector.resize(mSlidingDFT->getOutputLength());
+        mSlidingDFT->powerSpectrum(fftVector.data());
+    }
+    else {
+        mSlidingDFT.reset();
+
+        // The engine can be swapped between calls.
+        mSpectrogramEngine->setSpectralFrames(mSpectralFrames);
+        mSpectrogramEngine->compute(mData.data(), fftSamples, fsView, (int) outOverlap.size(), fftVector);
+        axis = mSpectrogramEngine->getAxis();
+        centreOffset = mSpectrogramEngine->getCentreOffset(fftSamples);
     }
 
-    auto fftVector = Analysis::fft_n(mFFT.get(), mData, mFFTWindowCache);
+    // Filterbank mode: only the band energies are stored, already on the view's frequency scale.
+    // Engines with a logarithmic axis are already compact and skip it.
+    const int bandCount = mConfig->getAnalysisSpectrogramBands();
+    const bool useFilterbank = (bandCount >= 2) && !axis.logarithmic;
+
+    if (useFilterbank) {
+        const FilterbankKey key(mConfig->getViewFrequencyScale(), mConfig->getViewMinFrequency(),
+                                bandCount, (int) fftVector.size(), fsView);
+        if (!mFilterbank || key != mFilterbankKey) {
+            mFilterbank = std::make_unique<Analysis::CSRFilterbank>(
+                    makeFilterbank(std::get<0>(key), std::get<1>(key), fsView / 2.0,
+                                   bandCount, (int) fftVector.size(), fsView));
+            mFilterbankKey = key;
+        }
+
+        mBands.resize(bandCount);
+        mFilterbank->apply(fftVector.data(), mBands.data());
+        fftVector.assign(mBands.begin(), mBands.end());
+    }
 
     double max = 0;
     for (const double& x : fftVector) {
@@ -56,7 +119,24 @@ void Spectrogram::processData(const rpm::vector<double>& overlap, double sampleR
 
     mDataStore->beginWrite();
     
-    mDataStore->getSpectrogram().insert(getCenteredTime() - (fftSamples / 2.0) / fsView, {fftVector, fsView});
+    Main::SpectrogramCoefs coefs { fftVector, fsView };
+    if (useFilterbank) {
+        coefs.scale = std::get<0>(mFilterbankKey);
+        coefs.minFrequency = std::get<1>(mFilterbankKey);
+        coefs.maxFrequency = fsView / 2.0;
+    }
+    else if (axis.logarithmic) {
+        coefs.scale = FrequencyScale::Logarithmic;
+        coefs.minFrequency = axis.minFrequency;
+        coefs.maxFrequency = axis.maxFrequency;
+    }
+    else {
+        coefs.scale = FrequencyScale::Linear;
+        coefs.minFrequency = 0.0;
+        coefs.maxFrequency = fsView / 2.0;
+    }
+
+    mDataStore->getSpectrogram().insert(getCenteredTime() - centreOffset / fsView, coefs);
 
     mDataStore->endWrite();
 }
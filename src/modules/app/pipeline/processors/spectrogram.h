@@ -4,6 +4,7 @@
 #include "rpcxx.h"
 
 #include <memory>
+#include <tuple>
 
 #include "../../../audio/resampler/resampler.h"
 #include "../../../../analysis/fft/fft.h"
@@ -16,7 +17,9 @@ namespace Module::App::Processors {
 
     class Spectrogram : public BaseProcessor {
     public:
-        Spectrogram(Main::Config *config, Main::DataStore *dataStore);
+        Spectrogram(Main::Config *config, Main::DataStore *dataStore,
+            std::shared_ptr<Analysis::SpectrogramEngine>& spectrogramEngine,
+            Analysis::SpectralFrames *spectralFrames);
         
         void processData(const rpm::vector<double>& data, double sampleRate) override;
 
@@ -27,8 +30,17 @@ namespace Module::App::Processors {
         Module::Audio::Resampler mResampler;
         rpm::vector<double> mData;
 
-        std::unique_ptr<Analysis::RealFFT> mFFT;
-        rpm::map<int, rpm::vector<double>> mFFTWindowCache;
+        std::shared_ptr<Analysis::SpectrogramEngine>& mSpectrogramEngine;
+        Analysis::SpectralFrames *mSpectralFrames;
+        std::unique_ptr<Analysis::SlidingDFT> mSlidingDFT;
+        double mSlidingSampleRate;
+
+        // Scale, minimum frequency, band count, bin count and sample rate of the cached filterbank.
+        using FilterbankKey = std::tuple<FrequencyScale, double, int, int, double>;
+        std::unique_ptr<Analysis::CSRFilterbank> mFilterbank;
+        FilterbankKey mFilterbankKey;
+        rpm::vector<double> mBands;
+
         rpm::vector<std::array<double, 6>> mHighpass;
         rpm::vector<rpm::vector<double>> mHighpassMemory;
         double mHighpassSampleRate;
@@ -92,8 +92,18 @@ int Resampler::getExpectedOutLength(int inLength) const
 
 rpm::vector<double> Resampler::process(const rpm::vector<double>& inDouble)
 {
-    rpm::vector<float> in(inDouble.begin(), inDouble.end());
-    rpm::vector<float> out(getExpectedOutLength(in.size()));
+    rpm::vector<double> outDouble;
+    process(inDouble, outDouble);
+    return outDouble;
+}
+
+void Resampler::process(const rpm::vector<double>& inDouble, rpm::vector<double>& outDouble)
+{
+    auto& in = mIn;
+    auto& out = mOut;
+
+    in.assign(inDouble.begin(), inDouble.end());
+    out.resize(getExpectedOutLength(in.size()));
 
     SRC_DATA data;
     data.data_in = in.data();
@@ -109,9 +119,9 @@ rpm::vector<double> Resampler::process(const rpm::vector<double>& inDouble)
         throw std::runtime_error("Audio::Resampler#" + std::to_string(mId) + "] " + src_strerror(error));
     }
 
-    out.resize(data.output_frames_gen);
-
-    return rpm::vector<double>(out.begin(), out.end());
+    // The generated count varies by a sample between calls, so size for the expected length.
+    outDouble.reserve(out.size());
+    outDouble.assign(out.begin(), out.begin() + data.output_frames_gen);
 }
 
 void Resampler::setupResampler()
@@ -29,6 +29,7 @@ namespace Module::Audio {
         int getExpectedOutLength(int inLength) const;
 
         rpm::vector<double> process(const rpm::vector<double>& in);
+        void process(const rpm::vector<double>& in, rpm::vector<double>& out);
 
     private:
         void updateRatio();
@@ -39,6 +40,8 @@ namespace Module::Audio {
         SRC_STATE *mSrc;
         int mInRate, mOutRate;
 
+        rpm::vector<float> mIn, mOut;
+
         static std::atomic_int sId;
     };
 
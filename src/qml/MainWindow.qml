@@ -249,6 +249,17 @@ ApplicationWindow {
                         Layout.alignment: Qt.AlignHCenter
                     }
 
+                    MenuSeparator {}
+
+                    Label { text: "Spectrogram algorithm:" }
+                    ComboBox {
+                        implicitWidth: parent.width - 10
+                        model: [ "Standard", "Reassigned", "Multitaper", "Constant-Q" ]
+                        currentIndex: config.spectrogramAlgorithm
+                        onActivated: config.spectrogramAlgorithm = currentIndex
+                        Layout.alignment: Qt.AlignHCenter
+                    }
+
                     MenuSeparator {}
                     
                     Label { text: "FFT size" }
@@ -291,7 +302,7 @@ ApplicationWindow {
                     Label { text: "Pitch algorithm:" }
                     ComboBox {
                         implicitWidth: parent.width - 10
-                        model: [ "YIN", "McLeod", "RAPT" ]
+                        model: [ "YIN", "McLeod", "RAPT", "IRAPT", "AMDF-M" ]
                         currentIndex: config.pitchAlgorithm
                         onActivated: config.pitchAlgorithm = currentIndex
                         Layout.alignment: Qt.AlignHCenter
@@ -303,8 +314,8 @@ ApplicationWindow {
                     ComboBox {
                         implicitWidth: parent.width - 10
                         model: HAS_TORCH 
-                                    ? [ "Simple LPC", "Filtered LPC", "DeepFormants" ] 
-                                    : [ "Simple LPC", "Filtered LPC" ]
+                                    ? [ "Simple LPC", "Filtered LPC", "KARMA", "DeepFormants" ] 
+                                    : [ "Simple LPC", "Filtered LPC", "KARMA" ]
                         currentIndex: config.formantAlgorithm
                         onActivated: config.formantAlgorithm = currentIndex
                         Layout.alignment: Qt.AlignHCenter